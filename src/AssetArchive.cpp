@@ -0,0 +1,248 @@
+#include "AssetArchive.h"
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char kMagic[4] = { 'S', 'P', 'A', 'K' };
+static const uint32_t kVersion = 2;
+static const size_t kPayloadAlignment = 4096;
+// Un octet LZ4 ne décrit jamais plus de 255 octets décompressés : au-delà,
+// la taille annoncée est fausse et ne doit pas être allouée.
+static const uint64_t kMaxLz4Ratio = 255;
+
+enum : uint32_t {
+    kStored = 0,
+    kLz4 = 1
+};
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t namesSize;
+};
+
+// Entrées de 48 octets après un en-tête de 16 : leurs champs 64 bits
+// restent alignés dans la projection, lue directement.
+struct ArchiveEntry {
+    uint32_t nameOffset, nameLength;  // dans la table des noms
+    uint64_t offset, storedSize;      // depuis le début du fichier
+    uint64_t size;                    // taille décompressée
+    uint64_t hash;                    // FNV-1a du contenu décompressé
+    uint32_t compression, reserved;
+};
+
+// FNV-1a 64 bits
+static uint64_t hashBytes(const unsigned char *data, size_t size) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static const ArchiveEntry *entryAt(const unsigned char *index, size_t i) {
+    return reinterpret_cast<const ArchiveEntry *>(index + i * sizeof(ArchiveEntry));
+}
+
+static size_t alignUp(size_t n, size_t alignment) { return (n + alignment - 1) / alignment * alignment; }
+
+bool AssetArchive::open(const std::string &path) {
+    close();
+    if (!m_file.open(path))
+        return false;
+
+    ArchiveHeader header;
+    if (m_file.size() < sizeof(header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    const size_t namesStart = sizeof(header) + size_t(header.entryCount) * sizeof(ArchiveEntry);
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion
+        || namesStart + header.namesSize > m_file.size()) {
+        std::cerr << "WARNING: " << path << " is not a valid asset archive" << std::endl;
+        close();
+        return false;
+    }
+    m_count = header.entryCount;
+    m_index = m_file.data() + sizeof(header);
+    m_names = reinterpret_cast<const char *>(m_file.data() + namesStart);
+    for (size_t i = 0; i < m_count; ++i) {
+        const ArchiveEntry &e = *entryAt(m_index, i);
+        // find() rend size octets pris dans le fichier (stocké) ou alloués (LZ4)
+        const bool sizeValid = e.compression == kStored ? e.size == e.storedSize
+                             : e.compression == kLz4 && e.size / kMaxLz4Ratio <= e.storedSize;
+        if (size_t(e.nameOffset) + e.nameLength > header.namesSize || e.offset > m_file.size()
+            || e.storedSize > m_file.size() - e.offset || !sizeValid) {
+            std::cerr << "WARNING: corrupted asset archive " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    m_inflated.resize(m_count);
+
+    const size_t slash = path.find_last_of('/');
+    m_directory = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    return true;
+}
+
+void AssetArchive::close() {
+    m_file.close();
+    m_count = 0;
+    m_index = nullptr;
+    m_names = nullptr;
+    m_inflated.clear();
+}
+
+long AssetArchive::lookup(const std::string &path) const {
+    if (!isOpen())
+        return -1;
+    std::string key = path;
+    if (!m_directory.empty() && key.compare(0, m_directory.size(), m_directory) == 0)
+        key.erase(0, m_directory.size());
+
+    size_t lo = 0, hi = m_count;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        const ArchiveEntry &e = *entryAt(m_index, mid);
+        const int order = key.compare(0, std::string::npos, m_names + e.nameOffset, e.nameLength);
+        if (order == 0)
+            return long(mid);
+        if (order < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return -1;
+}
+
+bool AssetArchive::contains(const std::string &path, size_t &size, uint64_t &hash) const {
+    const long index = lookup(path);
+    if (index < 0)
+        return false;
+    const ArchiveEntry &e = *entryAt(m_index, size_t(index));
+    size = size_t(e.size);
+    hash = e.hash;
+    return true;
+}
+
+bool AssetArchive::find(const std::string &path, AssetSpan &out) const {
+    const long index = lookup(path);
+    if (index < 0)
+        return false;
+    const ArchiveEntry &e = *entryAt(m_index, size_t(index));
+    if (e.compression == kStored) {
+        out.data = m_file.data() + e.offset;  // sans copie
+        out.size = size_t(e.size);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_inflateMutex);
+    std::unique_ptr<std::vector<unsigned char>> &inflated = m_inflated[size_t(index)];
+    if (!inflated) {
+        std::unique_ptr<std::vector<unsigned char>> buffer(new std::vector<unsigned char>(size_t(e.size)));
+        if (e.compression != kLz4
+            || !lz4Decompress(m_file.data() + e.offset, size_t(e.storedSize), buffer->data(), buffer->size())) {
+            std::cerr << "WARNING: cannot decompress " << path << " from the asset archive" << std::endl;
+            return false;
+        }
+        inflated = std::move(buffer);
+    }
+    out.data = inflated->data();
+    out.size = inflated->size();
+    return true;
+}
+
+size_t AssetArchive::inflatedBytes() const {
+    std::lock_guard<std::mutex> lock(m_inflateMutex);
+    size_t bytes = 0;
+    for (size_t i = 0; i < m_inflated.size(); ++i)
+        bytes += m_inflated[i] ? m_inflated[i]->size() : 0;
+    return bytes;
+}
+
+bool writeAssetArchive(const std::string &path, std::vector<AssetSource> sources, bool lz4,
+                       size_t &original, size_t &stored) {
+    std::sort(sources.begin(), sources.end(),
+              [](const AssetSource &a, const AssetSource &b) { return a.name < b.name; });
+    original = stored = 0;
+
+    std::vector<std::vector<unsigned char>> payloads(sources.size());
+    std::vector<ArchiveEntry> index;
+    std::string names;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (i > 0 && sources[i].name == sources[i - 1].name) {
+            std::cerr << "ERROR: " << sources[i].name << " is packed twice" << std::endl;
+            return false;
+        }
+        MappedFile file;
+        if (!file.open(sources[i].file)) {
+            std::cerr << "ERROR: cannot read " << sources[i].file << std::endl;
+            return false;
+        }
+        ArchiveEntry e;
+        e.nameOffset = uint32_t(names.size());
+        e.nameLength = uint32_t(sources[i].name.size());
+        e.size = file.size();
+        e.hash = hashBytes(file.data(), file.size());
+        e.compression = kStored;
+        e.reserved = 0;
+        names += sources[i].name;
+
+        std::vector<unsigned char> &payload = payloads[i];
+        if (lz4) {
+            payload.resize(lz4CompressBound(file.size()));
+            const size_t compressed = lz4Compress(file.data(), file.size(), payload.data(), payload.size());
+            if (compressed > 0 && compressed <= file.size() - file.size() / 8) {
+                payload.resize(compressed);
+                e.compression = kLz4;
+            }
+        }
+        if (e.compression == kStored)
+            payload.assign(file.data(), file.data() + file.size());
+        e.storedSize = payload.size();
+        original += file.size();
+        stored += payload.size();
+        index.push_back(e);
+    }
+
+    ArchiveHeader header;
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.entryCount = uint32_t(index.size());
+    header.namesSize = uint32_t(names.size());
+    size_t offset = alignUp(sizeof(header) + index.size() * sizeof(ArchiveEntry) + names.size(), kPayloadAlignment);
+    for (size_t i = 0; i < index.size(); ++i) {
+        index[i].offset = offset;
+        offset = alignUp(offset + payloads[i].size(), kPayloadAlignment);
+    }
+
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "ERROR: cannot write " << temp << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(index.data()), std::streamsize(index.size() * sizeof(ArchiveEntry)));
+        file.write(names.data(), std::streamsize(names.size()));
+        const std::vector<char> zeros(kPayloadAlignment, 0);
+        size_t written = sizeof(header) + index.size() * sizeof(ArchiveEntry) + names.size();
+        for (size_t i = 0; i < index.size(); ++i) {
+            file.write(zeros.data(), std::streamsize(index[i].offset - written));
+            file.write(reinterpret_cast<const char *>(payloads[i].data()), std::streamsize(payloads[i].size()));
+            written = index[i].offset + payloads[i].size();
+        }
+        if (!file)
+            return false;
+    }
+    std::remove(path.c_str());  // rename n'écrase pas sous Windows
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
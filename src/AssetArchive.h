@@ -0,0 +1,72 @@
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+// Contenu d'une ressource : pointe dans l'archive projetée (ou dans le
+// tampon décompressé qu'elle garde), valide tant que l'archive est ouverte.
+struct AssetSpan {
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+};
+
+// Archive (.pak) de ressources en un seul fichier : en-tête, index trié
+// par nom, table des noms, puis les contenus alignés sur 4 Kio (une page :
+// chaque ressource est projetée sans partager de page avec sa voisine).
+// Un contenu peut être compressé en LZ4 (voir Lz4.h) ; il n'est alors
+// décompressé qu'au premier accès, une seule fois.
+//
+// Les noms sont relatifs au dossier de l'archive : ouverte sous
+// "../../assets.pak", find("../../media/earth.jpg") cherche
+// "media/earth.jpg", si bien que les appelants gardent leurs chemins et
+// retombent sur les fichiers isolés quand l'archive manque.
+class AssetArchive
+{
+public:
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Recherche dichotomique ; false si le chemin n'est pas dans l'archive.
+    bool find(const std::string &path, AssetSpan &out) const;
+    // Comme find, sans décompresser : taille du contenu et empreinte
+    // (FNV-1a 64 bits) calculée à l'empaquetage. Elle ne change que si le
+    // contenu change, même quand l'archive est reconstruite.
+    bool contains(const std::string &path, size_t &size, uint64_t &hash) const;
+
+    size_t entryCount() const { return m_count; }
+    size_t inflatedBytes() const;
+
+private:
+    // Indice de l'entrée, -1 si absente.
+    long lookup(const std::string &path) const;
+
+    MappedFile m_file;
+    std::string m_directory;  // préfixe retiré des chemins, avec '/' final
+    size_t m_count = 0;
+    const unsigned char *m_index = nullptr;
+    const char *m_names = nullptr;
+
+    mutable std::mutex m_inflateMutex;
+    mutable std::vector<std::unique_ptr<std::vector<unsigned char>>> m_inflated;  // par entrée compressée
+};
+
+// Une ressource à empaqueter : nom dans l'archive, fichier à lire.
+struct AssetSource {
+    std::string name, file;
+};
+
+// Écrit l'archive (les noms sont triés ici). Avec lz4, un contenu n'est
+// gardé compressé que s'il y gagne au moins un huitième. stored reçoit
+// la taille totale des contenus écrits, original celle des fichiers.
+bool writeAssetArchive(const std::string &path, std::vector<AssetSource> sources, bool lz4,
+                       size_t &original, size_t &stored);
+
+#endif // ASSETARCHIVE_H
@@ -0,0 +1,209 @@
+#include "BlockCompression.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+static const size_t kBlockRowsPerJob = 4;
+
+size_t blockCompressedSize(int width, int height) {
+    return blockRowBytes(width) * size_t((height + 3) / 4);
+}
+
+// Les 16 texels RGB du bloc (bx, by), bords répétés.
+static void fetchBlock(const unsigned char *pixels, int width, int height, int channels,
+                       int bx, int by, float out[16][3]) {
+    for (int k = 0; k < 16; ++k) {
+        const int x = std::min(bx * 4 + k % 4, width - 1);
+        const int y = std::min(by * 4 + k / 4, height - 1);
+        const unsigned char *p = pixels + (size_t(y) * width + x) * channels;
+        for (int c = 0; c < 3; ++c)
+            out[k][c] = float(p[c]);
+    }
+}
+
+// --- BC1 ---
+
+static uint16_t packRgb565(const float rgb[3]) {
+    const int r = int(std::min(std::max(rgb[0], 0.f), 255.f) * 31.f / 255.f + 0.5f);
+    const int g = int(std::min(std::max(rgb[1], 0.f), 255.f) * 63.f / 255.f + 0.5f);
+    const int b = int(std::min(std::max(rgb[2], 0.f), 255.f) * 31.f / 255.f + 0.5f);
+    return uint16_t((r << 11) | (g << 5) | b);
+}
+
+static void unpackRgb565(uint16_t c, float rgb[3]) {
+    const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = float((r << 3) | (r >> 2));
+    rgb[1] = float((g << 2) | (g >> 4));
+    rgb[2] = float((b << 3) | (b >> 2));
+}
+
+// Les 4 couleurs d'un bloc ; c0 > c1 : mode 4 couleurs (le seul produit ici).
+static void bc1Palette(uint16_t c0, uint16_t c1, float palette[4][3]) {
+    unpackRgb565(c0, palette[0]);
+    unpackRgb565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        if (c0 > c1) {
+            palette[2][c] = (2.f * palette[0][c] + palette[1][c]) / 3.f;
+            palette[3][c] = (palette[0][c] + 2.f * palette[1][c]) / 3.f;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2.f;
+            palette[3][c] = 0.f;
+        }
+    }
+}
+
+static float squaredDistance(const float a[3], const float b[3]) {
+    const float dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+    return dr * dr + dg * dg + db * db;
+}
+
+// Choisit l'indice le plus proche de chaque texel ; renvoie l'erreur totale.
+static float bc1Indices(const float texels[16][3], uint16_t c0, uint16_t c1, uint32_t &indices) {
+    float palette[4][3];
+    bc1Palette(c0, c1, palette);
+    float error = 0.f;
+    indices = 0;
+    for (int k = 0; k < 16; ++k) {
+        int best = 0;
+        float bestDistance = squaredDistance(texels[k], palette[0]);
+        for (int i = 1; i < 4; ++i) {
+            const float d = squaredDistance(texels[k], palette[i]);
+            if (d < bestDistance) {
+                bestDistance = d;
+                best = i;
+            }
+        }
+        indices |= uint32_t(best) << (2 * k);
+        error += bestDistance;
+    }
+    return error;
+}
+
+// Range c0 > c1 (mode 4 couleurs) ; deux extrémités égales donnent un bloc uni.
+static void orderEndpoints(uint16_t &c0, uint16_t &c1) {
+    if (c0 < c1)
+        std::swap(c0, c1);
+}
+
+static void encodeBC1Block(const float texels[16][3], unsigned char *out) {
+    // axe principal des couleurs du bloc (itération de la puissance sur la covariance)
+    float mean[3] = { 0.f, 0.f, 0.f };
+    for (int k = 0; k < 16; ++k)
+        for (int c = 0; c < 3; ++c)
+            mean[c] += texels[k][c] / 16.f;
+    float cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };  // rr rg rb gg gb bb
+    for (int k = 0; k < 16; ++k) {
+        const float r = texels[k][0] - mean[0], g = texels[k][1] - mean[1], b = texels[k][2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+    float axis[3] = { 1.f, 1.f, 1.f };
+    for (int it = 0; it < 8; ++it) {
+        const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        const float length = std::sqrt(x * x + y * y + z * z);
+        if (length < 1e-6f)
+            break;  // bloc uni : l'axe n'importe pas
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    // extrémités : projections extrêmes sur l'axe
+    float lo = 1e30f, hi = -1e30f;
+    for (int k = 0; k < 16; ++k) {
+        const float t = (texels[k][0] - mean[0]) * axis[0] + (texels[k][1] - mean[1]) * axis[1]
+                      + (texels[k][2] - mean[2]) * axis[2];
+        lo = std::min(lo, t);
+        hi = std::max(hi, t);
+    }
+    float e0[3], e1[3];
+    for (int c = 0; c < 3; ++c) {
+        e0[c] = mean[c] + hi * axis[c];
+        e1[c] = mean[c] + lo * axis[c];
+    }
+    uint16_t c0 = packRgb565(e0), c1 = packRgb565(e1);
+    orderEndpoints(c0, c1);
+    uint32_t indices;
+    float error = bc1Indices(texels, c0, c1, indices);
+
+    // affinage : moindres carrés sur les extrémités, à indices fixés
+    if (c0 != c1) {
+        static const float kWeight[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };  // part de c0
+        float aa = 0.f, ab = 0.f, bb = 0.f, ap[3] = { 0.f, 0.f, 0.f }, bp[3] = { 0.f, 0.f, 0.f };
+        for (int k = 0; k < 16; ++k) {
+            const float a = kWeight[(indices >> (2 * k)) & 3], b = 1.f - a;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (int c = 0; c < 3; ++c) {
+                ap[c] += a * texels[k][c];
+                bp[c] += b * texels[k][c];
+            }
+        }
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) > 1e-6f) {
+            for (int c = 0; c < 3; ++c) {
+                e0[c] = (bb * ap[c] - ab * bp[c]) / det;
+                e1[c] = (aa * bp[c] - ab * ap[c]) / det;
+            }
+            uint16_t r0 = packRgb565(e0), r1 = packRgb565(e1);
+            orderEndpoints(r0, r1);
+            uint32_t refined;
+            const float refinedError = bc1Indices(texels, r0, r1, refined);
+            if (refinedError < error) {
+                c0 = r0;
+                c1 = r1;
+                indices = refined;
+                error = refinedError;
+            }
+        }
+    }
+    if (c0 == c1)
+        indices = 0;
+
+    out[0] = (unsigned char)(c0 & 0xff);
+    out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xff);
+    out[3] = (unsigned char)(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        out[4 + i] = (unsigned char)(indices >> (8 * i));
+}
+
+// --- Parcours des blocs ---
+
+std::vector<unsigned char> encodeBC1(const unsigned char *pixels, int width, int height, int channels) {
+    const int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    std::vector<unsigned char> out(blockCompressedSize(width, height));
+    JobSystem::shared().parallelFor(size_t(blocksY), kBlockRowsPerJob, [&](size_t begin, size_t end) {
+        float texels[16][3];
+        for (size_t by = begin; by < end; ++by) {
+            for (int bx = 0; bx < blocksX; ++bx) {
+                fetchBlock(pixels, width, height, channels, bx, int(by), texels);
+                encodeBC1Block(texels, &out[(by * blocksX + bx) * kBlockBytes]);
+            }
+        }
+    });
+    return out;
+}
+
+std::vector<unsigned char> decodeBC1(const unsigned char *blocks, int width, int height) {
+    const int blocksX = (width + 3) / 4;
+    std::vector<unsigned char> out(size_t(width) * height * 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const unsigned char *block = blocks + (size_t(y / 4) * blocksX + x / 4) * kBlockBytes;
+            const uint16_t c0 = uint16_t(block[0] | (block[1] << 8)), c1 = uint16_t(block[2] | (block[3] << 8));
+            const int k = (y % 4) * 4 + x % 4;
+            const int index = (block[4 + k / 4] >> (2 * (k % 4))) & 3;
+            float palette[4][3];
+            bc1Palette(c0, c1, palette);
+            for (int c = 0; c < 3; ++c)
+                out[(size_t(y) * width + x) * 3 + c] = (unsigned char)(palette[index][c] + 0.5f);
+        }
+    }
+    return out;
+}
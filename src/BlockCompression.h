@@ -0,0 +1,28 @@
+#ifndef BLOCKCOMPRESSION_H
+#define BLOCKCOMPRESSION_H
+
+#include <cstddef>
+#include <vector>
+
+// Compression par blocs de 4x4 texels, au format lu directement par le GPU :
+// BC1 (DXT1, GL_EXT_texture_compression_s3tc), couleur RGB, deux extrémités
+// 5:6:5 et un indice de 2 bits par texel, 8 octets par bloc. Soit 0,5 octet
+// par texel au lieu de 3 (RGB8). Les blocs sont rangés ligne par ligne ; les
+// bords d'une image non multiple de 4 sont complétés en répétant le dernier
+// texel.
+
+static const size_t kBlockBytes = 8;
+
+// Octets d'une image compressée (w x h, un niveau).
+size_t blockCompressedSize(int width, int height);
+// Octets d'une ligne de blocs (4 lignes de texels).
+inline size_t blockRowBytes(int width) { return size_t((width + 3) / 4) * kBlockBytes; }
+
+// pixels : channels octets par texel (au moins 3), seuls les trois premiers
+// canaux sont lus.
+std::vector<unsigned char> encodeBC1(const unsigned char *pixels, int width, int height, int channels);
+
+// Décodage de référence (RGB), pour mesurer l'erreur.
+std::vector<unsigned char> decodeBC1(const unsigned char *blocks, int width, int height);
+
+#endif // BLOCKCOMPRESSION_H
@@ -0,0 +1,65 @@
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "SimdMath.h"
+
+static const size_t kSpheresPerJob = 4096;
+
+Frustum::Frustum(const glm::mat4 &viewProj) {
+    // glm est en colonnes : la ligne r de la matrice est (m[0][r], m[1][r], m[2][r], m[3][r])
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; ++r)
+        row[r] = glm::vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+
+    planes[0] = row[3] + row[0];
+    planes[1] = row[3] - row[0];
+    planes[2] = row[3] + row[1];
+    planes[3] = row[3] - row[1];
+    planes[4] = row[3] + row[2];
+    planes[5] = row[3] - row[2];
+    for (int p = 0; p < 6; ++p)
+        planes[p] /= glm::length(glm::vec3(planes[p]));
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+    for (int p = 0; p < 6; ++p) {
+        if (glm::dot(glm::vec3(planes[p]), center) + planes[p].w < -radius)
+            return false;
+    }
+    return true;
+}
+
+static void cullRange(const Frustum &frustum, size_t begin, size_t end, const float *x, const float *y,
+                      const float *z, const float *radius, unsigned char *visible) {
+    size_t i = begin;
+#ifdef SIMD_WIDTH
+    vfloat a[6], b[6], c[6], d[6];
+    for (int p = 0; p < 6; ++p) {
+        a[p] = vset(frustum.planes[p].x);
+        b[p] = vset(frustum.planes[p].y);
+        c[p] = vset(frustum.planes[p].z);
+        d[p] = vset(frustum.planes[p].w);
+    }
+    const vfloat zero = vset(0.f);
+    for (; i + SIMD_WIDTH <= end; i += SIMD_WIDTH) {
+        const vfloat px = vload(x + i), py = vload(y + i), pz = vload(z + i), r = vload(radius + i);
+        vfloat inside = vcmpeq(zero, zero);
+        for (int p = 0; p < 6; ++p) {
+            // distance signée au plan, élargie du rayon
+            const vfloat dist = vadd(vadd(vmul(a[p], px), vmul(b[p], py)), vadd(vmul(c[p], pz), vadd(d[p], r)));
+            inside = vand(inside, vcmpge(dist, zero));
+        }
+        const int mask = vmovemask(inside);
+        for (int l = 0; l < SIMD_WIDTH; ++l)
+            visible[i + l] = (unsigned char)((mask >> l) & 1);
+    }
+#endif
+    for (; i < end; ++i)
+        visible[i] = frustum.intersectsSphere(glm::vec3(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+}
+
+void cullSpheres(const Frustum &frustum, size_t n, const float *x, const float *y,
+                 const float *z, const float *radius, unsigned char *visible) {
+    JobSystem::shared().parallelFor(n, kSpheresPerJob, [&](size_t begin, size_t end) {
+        cullRange(frustum, begin, end, x, y, z, radius, visible);
+    });
+}
@@ -0,0 +1,23 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Les 6 plans du volume de vue, extraits de projection * vue (méthode de
+// Gribb et Hartmann), normales unitaires orientées vers l'intérieur.
+struct Frustum {
+    glm::vec4 planes[6];  // gauche, droite, bas, haut, proche, lointain
+
+    explicit Frustum(const glm::mat4 &viewProj);
+
+    bool intersectsSphere(const glm::vec3 &center, float radius) const;
+};
+
+// Teste n sphères englobantes (tableaux contigus) contre le frustum,
+// plusieurs à la fois (AVX2 : 8, SSE2 : 4), réparties sur JobSystem.
+// visible[i] vaut 1 si la sphère i coupe le volume de vue, 0 sinon.
+void cullSpheres(const Frustum &frustum, size_t n, const float *x, const float *y,
+                 const float *z, const float *radius, unsigned char *visible);
+
+#endif // FRUSTUM_H
@@ -0,0 +1,168 @@
+#include "JobSystem.h"
+
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int kSpinsBeforeSleep = 64;
+
+// Indice du thread de travail courant, -1 pour les threads extérieurs.
+static thread_local int t_worker = -1;
+// Profondeur d'imbrication des tâches : seule la plus externe est chronométrée.
+static thread_local int t_depth = 0;
+
+static uint64_t elapsedNs(Clock::time_point since) {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count());
+}
+
+JobSystem::JobSystem(unsigned workers) {
+    if (workers == 0) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        workers = cores > 1 ? cores - 1 : 0;
+    }
+    for (unsigned i = 0; i < workers; ++i)
+        m_workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    // les files existent toutes avant le premier vol
+    for (unsigned i = 0; i < workers; ++i)
+        m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, int(i));
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (size_t i = 0; i < m_workers.size(); ++i)
+        m_workers[i]->thread.join();
+}
+
+JobSystem &JobSystem::shared() {
+    static JobSystem instance;
+    return instance;
+}
+
+// Traite une tâche en publiant successivement la moitié haute de l'intervalle.
+void JobSystem::run(Task task) {
+    RangeBase &range = *task.range;
+    while (task.end - task.begin > range.grain) {
+        const size_t mid = task.begin + (task.end - task.begin) / 2;
+        push(Task{ task.range, mid, task.end });
+        task.end = mid;
+    }
+    range.execute(task.begin, task.end);
+    // dernière écriture sur range : l'appelant peut le détruire ensuite
+    range.remaining.fetch_sub(task.end - task.begin, std::memory_order_release);
+}
+
+void JobSystem::push(const Task &task) {
+    // un thread extérieur dépose dans les files à tour de rôle
+    const unsigned queue = t_worker >= 0 ? unsigned(t_worker) : m_nextQueue++ % unsigned(m_workers.size());
+    Worker &worker = *m_workers[queue];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(task);
+    }
+    if (m_queued++ == 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wake.notify_all();
+    }
+}
+
+bool JobSystem::tryRunOne(int self) {
+    Task task;
+    bool found = false, stolen = false;
+    if (self >= 0) {
+        Worker &own = *m_workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    const size_t n = m_workers.size();
+    const size_t start = self >= 0 ? size_t(self) + 1 : size_t(m_nextQueue.load(std::memory_order_relaxed));
+    for (size_t k = 0; !found && k < n; ++k) {
+        const size_t victim = (start + k) % n;
+        if (int(victim) == self)
+            continue;
+        Worker &other = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = other.tasks.front();
+            other.tasks.pop_front();
+            found = stolen = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    --m_queued;
+    Worker &stats = self >= 0 ? *m_workers[self] : m_external;
+    const Clock::time_point begin = Clock::now();
+    ++t_depth;
+    run(task);
+    if (--t_depth == 0)
+        stats.busyNs += elapsedNs(begin);
+    ++stats.jobs;
+    if (stolen)
+        ++stats.steals;
+    return true;
+}
+
+void JobSystem::waitFor(RangeBase &range) {
+    Worker &stats = t_worker >= 0 ? *m_workers[t_worker] : m_external;
+    while (range.remaining.load(std::memory_order_acquire) > 0) {
+        if (tryRunOne(t_worker))
+            continue;
+        // le reste est déjà pris par d'autres threads
+        const Clock::time_point begin = Clock::now();
+        std::this_thread::yield();
+        if (t_depth == 0)
+            stats.idleNs += elapsedNs(begin);
+    }
+}
+
+void JobSystem::workerLoop(int self) {
+    t_worker = self;
+    Worker &worker = *m_workers[self];
+    int spins = 0;
+    while (!m_stopping) {
+        if (tryRunOne(self)) {
+            spins = 0;
+            continue;
+        }
+        const Clock::time_point begin = Clock::now();
+        if (++spins < kSpinsBeforeSleep) {
+            std::this_thread::yield();
+        } else {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+            spins = 0;
+        }
+        worker.idleNs += elapsedNs(begin);
+    }
+}
+
+std::vector<JobSystem::WorkerStats> JobSystem::stats() const {
+    std::vector<WorkerStats> out(m_workers.size() + 1);
+    for (size_t i = 0; i < out.size(); ++i) {
+        const Worker &w = i < m_workers.size() ? *m_workers[i] : m_external;
+        out[i].busySeconds = double(w.busyNs) * 1e-9;
+        out[i].idleSeconds = double(w.idleNs) * 1e-9;
+        out[i].jobs = w.jobs;
+        out[i].steals = w.steals;
+    }
+    return out;
+}
+
+void JobSystem::resetStats() {
+    for (size_t i = 0; i <= m_workers.size(); ++i) {
+        Worker &w = i < m_workers.size() ? *m_workers[i] : m_external;
+        w.busyNs = 0;
+        w.idleNs = 0;
+        w.jobs = 0;
+        w.steals = 0;
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Ordonnanceur par vol de tâches : chaque thread de travail possède sa file,
+// dépile ses propres tâches par la fin (LIFO, données chaudes en cache) et,
+// à vide, vole par le début de la file des autres. parallelFor découpe
+// récursivement l'intervalle : une moitié est publiée, l'autre traitée sur
+// place, si bien que les threads inoccupés trouvent toujours de gros
+// morceaux à voler.
+class JobSystem
+{
+public:
+    // Compteurs cumulés d'un thread de travail.
+    struct WorkerStats {
+        double busySeconds = 0.0;
+        double idleSeconds = 0.0;
+        uint64_t jobs = 0;
+        uint64_t steals = 0;
+    };
+
+    // workers = 0 : un thread par cœur, moins le thread appelant.
+    explicit JobSystem(unsigned workers = 0);
+    ~JobSystem();
+
+    // Instance partagée par tout le programme.
+    static JobSystem &shared();
+
+    unsigned workerCount() const { return unsigned(m_workers.size()); }
+
+    // Appelle body(begin, end) sur des tranches d'au plus grain éléments
+    // couvrant [0, count) et rend la main quand tout est traité. Le thread
+    // appelant participe ; les appels imbriqués sont permis.
+    template<typename F>
+    void parallelFor(size_t count, size_t grain, F body);
+
+    // Un élément par thread de travail, plus un dernier pour les threads
+    // extérieurs (principal, simulation) pendant qu'ils attendent.
+    std::vector<WorkerStats> stats() const;
+    void resetStats();
+
+private:
+    struct RangeBase {
+        std::atomic<size_t> remaining;
+        size_t grain;
+        virtual void execute(size_t begin, size_t end) = 0;
+        virtual ~RangeBase() {}
+    };
+    template<typename F>
+    struct Range : RangeBase {
+        F &body;
+        explicit Range(F &f) : body(f) {}
+        void execute(size_t begin, size_t end) override { body(begin, end); }
+    };
+    struct Task {
+        RangeBase *range;
+        size_t begin, end;
+    };
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+        std::atomic<uint64_t> busyNs{0}, idleNs{0}, jobs{0}, steals{0};
+    };
+
+    void run(Task task);
+    void push(const Task &task);
+    bool tryRunOne(int self);
+    void waitFor(RangeBase &range);
+    void workerLoop(int self);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    Worker m_external;                 // statistiques des threads extérieurs
+    std::atomic<unsigned> m_nextQueue{0};
+    std::atomic<int> m_queued{0};      // tâches en attente, toutes files confondues
+    std::atomic<bool> m_stopping{false};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+};
+
+template<typename F>
+void JobSystem::parallelFor(size_t count, size_t grain, F body) {
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+    if (m_workers.empty() || count <= grain) {
+        body(0, count);
+        return;
+    }
+
+    Range<F> range(body);
+    range.remaining = count;
+    range.grain = grain;
+    run(Task{ &range, 0, count });
+    waitFor(range);
+}
+
+#endif // JOBSYSTEM_H
@@ -0,0 +1,81 @@
+#include "Kepler.h"
+#include "SimdMath.h"
+
+#include <cmath>
+
+static const float kTwoPi = 6.28318530718f;
+static const double kTwoPiD = 6.283185307179586;
+
+void keplerAxes(float semiMajorAxis, float eccentricity, float inclination,
+                float ascendingNode, float argPeriapsis, glm::vec3 &p, glm::vec3 &q) {
+    const float cO = std::cos(ascendingNode), sO = std::sin(ascendingNode);
+    const float cw = std::cos(argPeriapsis), sw = std::sin(argPeriapsis);
+    const float ci = std::cos(inclination), si = std::sin(inclination);
+
+    // base périfocale dans le repère écliptique classique (z vers le pôle nord)
+    const glm::vec3 P(cO * cw - sO * sw * ci, sO * cw + cO * sw * ci, sw * si);
+    const glm::vec3 Q(-cO * sw - sO * cw * ci, -sO * sw + cO * cw * ci, cw * si);
+    const float b = semiMajorAxis * std::sqrt(1.f - eccentricity * eccentricity);
+
+    // écliptique (x, y, z) -> monde (x, z, -y)
+    p = semiMajorAxis * glm::vec3(P.x, P.z, -P.y);
+    q = b * glm::vec3(Q.x, Q.z, -Q.y);
+}
+
+float wrapAngle(double angle) {
+    return float(angle - kTwoPiD * std::floor(angle / kTwoPiD + 0.5));
+}
+
+float solveKepler(float meanAnomaly, float eccentricity) {
+    // M ramenée dans [-pi, pi], départ de Danby : E0 = M + 0.85 e signe(M)
+    const float M = meanAnomaly - kTwoPi * std::floor(meanAnomaly / kTwoPi + 0.5f);
+    float E = M + std::copysign(0.85f * eccentricity, M);
+    for (int k = 0; k < kKeplerIterations; ++k)
+        E -= (E - eccentricity * std::sin(E) - M) / (1.f - eccentricity * std::cos(E));
+    return E;
+}
+
+// Anomalie moyenne du corps i, formée et réduite en double.
+static inline float meanAnomaly(size_t i, double t, const KeplerBatch &in) {
+    return wrapAngle(double(in.meanAnomaly0[i]) + double(in.meanMotion[i]) * t);
+}
+
+static inline void propagateOne(size_t i, double t, const KeplerBatch &in, float *x, float *y, float *z) {
+    const float e = in.eccentricity[i];
+    const float E = solveKepler(meanAnomaly(i, t, in), e);
+    const float u = std::cos(E) - e, v = std::sin(E);
+    x[i] = in.px[i] * u + in.qx[i] * v;
+    y[i] = in.py[i] * u + in.qy[i] * v;
+    z[i] = in.pz[i] * u + in.qz[i] * v;
+}
+
+void propagateKepler(size_t n, double t, const KeplerBatch &in, float *x, float *y, float *z) {
+    size_t i = 0;
+#ifdef SIMD_WIDTH
+    for (; i + SIMD_WIDTH <= n; i += SIMD_WIDTH) {
+        const vfloat e = vload(in.eccentricity + i);
+        // M déjà dans [-pi, pi] : le solveur reste en float
+        alignas(32) float lane[SIMD_WIDTH];
+        for (size_t l = 0; l < SIMD_WIDTH; ++l)
+            lane[l] = meanAnomaly(i + l, t, in);
+        const vfloat M = vload(lane);
+
+        // même schéma que solveKepler, sans aucun branchement
+        vfloat E = vadd(M, vor(vmul(vset(0.85f), e), vand(M, vset(-0.f))));
+        vfloat s, c;
+        for (int k = 0; k < kKeplerIterations; ++k) {
+            vsincos(E, s, c);
+            const vfloat f = vsub(vsub(E, vmul(e, s)), M);
+            E = vsub(E, vdiv(f, vsub(vset(1.f), vmul(e, c))));
+        }
+        vsincos(E, s, c);
+
+        const vfloat u = vsub(c, e);
+        vstore(x + i, vadd(vmul(vload(in.px + i), u), vmul(vload(in.qx + i), s)));
+        vstore(y + i, vadd(vmul(vload(in.py + i), u), vmul(vload(in.qy + i), s)));
+        vstore(z + i, vadd(vmul(vload(in.pz + i), u), vmul(vload(in.qz + i), s)));
+    }
+#endif
+    for (; i < n; ++i)
+        propagateOne(i, t, in, x, y, z);
+}
@@ -0,0 +1,41 @@
+#ifndef KEPLER_H
+#define KEPLER_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Propagation képlérienne en forme fermée : la position au temps t ne
+// dépend que des éléments orbitaux, quel que soit le saut dans le temps.
+//
+// Repère monde : plan de l'écliptique = plan XZ, Y vers le haut. Avec
+// inclinaison, nœud et périapse nuls, le corps part de (a, 0, 0) et
+// tourne vers -Z, comme les orbites circulaires d'origine.
+
+// Nombre d'itérations de Newton, fixe pour que le solveur se vectorise.
+// Avec le point de départ de Danby, 6 suffisent en float jusqu'à e ~ 0.97.
+static const int kKeplerIterations = 6;
+
+// Entrées par corps (tableaux de taille n).
+struct KeplerBatch {
+    const float *eccentricity;
+    const float *meanMotion;    // rad par unité de temps
+    const float *meanAnomaly0;  // anomalie moyenne à t = 0
+    const float *px, *py, *pz;  // a * P : demi-grand axe, vers le périapse
+    const float *qx, *qy, *qz;  // b * Q : demi-petit axe, b = a sqrt(1 - e^2)
+};
+
+// Calcule a*P et b*Q à partir des éléments (angles en radians).
+void keplerAxes(float semiMajorAxis, float eccentricity, float inclination,
+                float ascendingNode, float argPeriapsis, glm::vec3 &p, glm::vec3 &q);
+
+// Angle ramené dans [-pi, pi] en double, puis arrondi en float : M0 + n t
+// garde sa précision quand t devient grand (un float seul perd la phase).
+float wrapAngle(double angle);
+
+// Anomalie excentrique E telle que E - e sin E = M (version scalaire).
+float solveKepler(float meanAnomaly, float eccentricity);
+
+// Positions relatives au foyer pour n corps au temps t.
+void propagateKepler(size_t n, double t, const KeplerBatch &in, float *x, float *y, float *z);
+
+#endif // KEPLER_H
@@ -0,0 +1,47 @@
+#include "Lod.h"
+
+#include <cmath>
+#include <limits>
+
+LodSelector::LodSelector(const std::vector<float> &thresholds, float hysteresis)
+    : m_thresholds(thresholds), m_hysteresis(hysteresis) {}
+
+LodSelector LodSelector::forSphereSegments(const std::vector<size_t> &segments, float maxErrorPixels) {
+    const float PI = 3.14159265359f;
+    std::vector<float> thresholds;
+    for (size_t i = 0; i + 1 < segments.size(); ++i) {
+        // flèche d'une corde sous-tendant 2π / segments : r (1 - cos(π / segments))
+        const float sagitta = 1.f - std::cos(PI / float(segments[i]));
+        thresholds.push_back(maxErrorPixels / sagitta);
+    }
+    return LodSelector(thresholds);
+}
+
+int LodSelector::select(size_t body, float pixelRadius) {
+    if (body >= m_level.size())
+        m_level.resize(body + 1, -1);
+
+    int level = m_level[body];
+    const int last = int(m_thresholds.size());
+    if (level < 0) {
+        // première apparition : pas d'historique, seuils exacts
+        level = 0;
+        while (level < last && pixelRadius > m_thresholds[level])
+            ++level;
+    } else {
+        while (level < last && pixelRadius > m_thresholds[level] * (1.f + m_hysteresis))
+            ++level;
+        while (level > 0 && pixelRadius < m_thresholds[level - 1] * (1.f - m_hysteresis))
+            --level;
+    }
+    m_level[body] = (signed char)level;
+    return level;
+}
+
+float projectedPixelRadius(float radius, float distance, float fovY, float viewportHeight) {
+    if (distance <= radius)
+        return std::numeric_limits<float>::max();  // caméra dans la sphère
+    // demi-angle apparent rapporté au demi-champ
+    const float angle = std::asin(radius / distance);
+    return std::tan(angle) / std::tan(0.5f * fovY) * 0.5f * viewportHeight;
+}
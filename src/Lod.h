@@ -0,0 +1,38 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <cstddef>
+#include <vector>
+
+// Choix d'un niveau de détail par corps selon son rayon projeté en pixels.
+// Les seuils sont élargis d'une marge (hystérésis) autour du niveau courant
+// de chaque corps : un corps à la frontière de deux niveaux ne clignote pas
+// de l'un à l'autre d'une image à la suivante.
+class LodSelector
+{
+public:
+    // thresholds[i] : rayon (pixels) au-delà duquel le niveau i + 1 remplace
+    // le niveau i ; croissants, un de moins que de niveaux.
+    explicit LodSelector(const std::vector<float> &thresholds, float hysteresis = 0.15f);
+
+    // Seuils d'une chaîne de sphères UV : le niveau i + 1 est pris dès que
+    // l'écart entre la sphère à segments[i] et la vraie sphère dépasse
+    // maxErrorPixels à l'écran.
+    static LodSelector forSphereSegments(const std::vector<size_t> &segments, float maxErrorPixels = 0.5f);
+
+    size_t levelCount() const { return m_thresholds.size() + 1; }
+
+    // Niveau du corps body pour cette image, mémorisé pour la suivante.
+    int select(size_t body, float pixelRadius);
+
+private:
+    std::vector<float> m_thresholds;
+    float m_hysteresis;
+    std::vector<signed char> m_level;  // -1 : corps jamais vu
+};
+
+// Rayon à l'écran, en pixels, d'une sphère de rayon radius à distance distance
+// d'une caméra perspective (champ vertical fovY en radians).
+float projectedPixelRadius(float radius, float distance, float fovY, float viewportHeight);
+
+#endif // LOD_H
@@ -0,0 +1,139 @@
+#include "Lz4.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static const size_t kMinMatch = 4;
+static const size_t kLastLiterals = 5;   // le bloc finit toujours par 5 littéraux
+static const size_t kMatchSafety = 12;   // aucune copie ne commence dans les 12 derniers octets
+static const size_t kMaxOffset = 65535;
+static const int kHashBits = 16;
+
+static uint32_t read32(const unsigned char *p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+static uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+// Longueur au-delà de 15 : octets de 255 puis le reste.
+static bool writeLength(size_t length, unsigned char *&out, unsigned char *end) {
+    for (; length >= 255; length -= 255) {
+        if (out == end)
+            return false;
+        *out++ = 255;
+    }
+    if (out == end)
+        return false;
+    *out++ = (unsigned char)length;
+    return true;
+}
+
+static bool writeSequence(const unsigned char *literals, size_t literalCount, size_t offset, size_t matchLength,
+                          unsigned char *&out, unsigned char *end) {
+    if (out == end)
+        return false;
+    unsigned char *token = out++;
+    *token = (unsigned char)((literalCount < 15 ? literalCount : 15) << 4);
+    if (literalCount >= 15 && !writeLength(literalCount - 15, out, end))
+        return false;
+    if (size_t(end - out) < literalCount)
+        return false;
+    std::memcpy(out, literals, literalCount);
+    out += literalCount;
+    if (matchLength == 0)
+        return true;  // dernière séquence : littéraux seuls
+
+    if (end - out < 2)
+        return false;
+    *out++ = (unsigned char)(offset & 0xff);
+    *out++ = (unsigned char)(offset >> 8);
+    const size_t extra = matchLength - kMinMatch;
+    *token |= (unsigned char)(extra < 15 ? extra : 15);
+    return extra < 15 || writeLength(extra - 15, out, end);
+}
+
+size_t lz4CompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t lz4Compress(const unsigned char *src, size_t size, unsigned char *dst, size_t capacity) {
+    unsigned char *out = dst, *end = dst + capacity;
+    size_t anchor = 0;
+    if (size > kMatchSafety) {
+        std::vector<uint32_t> table(size_t(1) << kHashBits, 0);  // position + 1, 0 : vide
+        const size_t matchLimit = size - kLastLiterals;
+        size_t ip = 0;
+        while (ip + kMatchSafety < size) {
+            const uint32_t sequence = read32(src + ip);
+            const uint32_t h = hash4(sequence);
+            const size_t candidate = table[h];
+            table[h] = uint32_t(ip + 1);
+            if (candidate == 0 || ip - (candidate - 1) > kMaxOffset || read32(src + candidate - 1) != sequence) {
+                ++ip;
+                continue;
+            }
+            const size_t ref = candidate - 1;
+            size_t length = kMinMatch;
+            while (ip + length < matchLimit && src[ref + length] == src[ip + length])
+                ++length;
+            if (!writeSequence(src + anchor, ip - anchor, ip - ref, length, out, end))
+                return 0;
+            ip += length;
+            anchor = ip;
+        }
+    }
+    if (!writeSequence(src + anchor, size - anchor, 0, 0, out, end))
+        return 0;
+    return size_t(out - dst);
+}
+
+static bool readLength(const unsigned char *&in, const unsigned char *end, size_t &length) {
+    unsigned char byte;
+    do {
+        if (in == end)
+            return false;
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool lz4Decompress(const unsigned char *src, size_t size, unsigned char *dst, size_t originalSize) {
+    const unsigned char *in = src, *inEnd = src + size;
+    unsigned char *out = dst, *outEnd = dst + originalSize;
+    while (in < inEnd) {
+        const unsigned char token = *in++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(in, inEnd, literals))
+            return false;
+        if (size_t(inEnd - in) < literals || size_t(outEnd - out) < literals)
+            return false;
+        std::memcpy(out, in, literals);
+        in += literals;
+        out += literals;
+        if (in == inEnd)
+            break;  // dernière séquence
+
+        if (inEnd - in < 2)
+            return false;
+        const size_t offset = size_t(in[0]) | size_t(in[1]) << 8;
+        in += 2;
+        size_t length = token & 15;
+        if (length == 15 && !readLength(in, inEnd, length))
+            return false;
+        length += kMinMatch;
+        if (offset == 0 || offset > size_t(out - dst) || size_t(outEnd - out) < length)
+            return false;
+        // octet par octet : la copie peut chevaucher sa source (répétitions)
+        const unsigned char *ref = out - offset;
+        for (size_t i = 0; i < length; ++i)
+            out[i] = ref[i];
+        out += length;
+    }
+    return out == outEnd;
+}
@@ -0,0 +1,21 @@
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+
+// Format de bloc LZ4 (sans l'en-tête de trame), compatible avec lz4 :
+// suite de séquences « littéraux puis copie d'une occurrence précédente à
+// au plus 64 Kio ». Compression gloutonne à table de hachage : rapide, au
+// ratio du niveau par défaut de lz4. La décompression vérifie toutes les
+// bornes : un bloc corrompu est refusé, jamais lu ou écrit hors tampon.
+
+// Taille de sortie suffisante dans le pire cas (données incompressibles).
+size_t lz4CompressBound(size_t size);
+
+// Renvoie la taille compressée, 0 si elle dépasse capacity.
+size_t lz4Compress(const unsigned char *src, size_t size, unsigned char *dst, size_t capacity);
+
+// originalSize : taille exacte attendue ; false si le bloc est invalide.
+bool lz4Decompress(const unsigned char *src, size_t size, unsigned char *dst, size_t originalSize);
+
+#endif // LZ4_H
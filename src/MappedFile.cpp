@@ -0,0 +1,61 @@
+#include "MappedFile.h"
+
+#include <fstream>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string &path) {
+    close();
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // la projection reste valide après fermeture
+    if (p == MAP_FAILED)
+        return false;
+    m_data = static_cast<const unsigned char *>(p);
+    m_size = size_t(st.st_size);
+    m_mapped = true;
+    return true;
+#else
+    std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!in || in.tellg() <= 0)
+        return false;
+    m_fallback.resize(size_t(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(m_fallback.data()), std::streamsize(m_fallback.size()));
+    m_data = m_fallback.data();
+    m_size = m_fallback.size();
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (m_mapped)
+        munmap(const_cast<unsigned char *>(m_data), m_size);
+#endif
+    m_fallback.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+bool fileStamp(const std::string &path, unsigned long long &size, long long &mtime) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return false;
+    size = (unsigned long long)st.st_size;
+    mtime = (long long)st.st_mtime;
+    return true;
+}
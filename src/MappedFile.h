@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Fichier projeté en mémoire en lecture seule : les pages ne sont lues
+// qu'au premier accès et restent partagées avec le cache du système.
+// Sans mmap (Windows), le fichier est lu en entier dans un tampon.
+class MappedFile
+{
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const unsigned char *data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const unsigned char *m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<unsigned char> m_fallback;
+};
+
+// Taille et date de modification d'un fichier ; false s'il n'existe pas.
+bool fileStamp(const std::string &path, unsigned long long &size, long long &mtime);
+
+#endif // MAPPEDFILE_H
@@ -1,4 +1,14 @@
 #include "Mesh.h"
+#include "JobSystem.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+static const size_t kRowsPerJob = 8; // lignes de latitude par tâche dans genSphere
 
 std::shared_ptr<Mesh> Mesh::genSphere(const size_t resolution) {
     auto mesh = std::make_shared<Mesh>();
@@ -7,51 +17,57 @@ std::shared_ptr<Mesh> Mesh::genSphere(const size_t resolution) {
     const size_t nbrdedivverticale = resolution;
     const size_t nbrdedivhorizontale = resolution;
 
-    // --- Génération des sommets ---
-    for (size_t i = 0; i <= nbrdedivverticale; ++i) {
-        float phi = PI * float(i) / float(nbrdedivverticale); // de 0 à π
-        for (size_t j = 0; j <= nbrdedivhorizontale; ++j) {
-            float theta = 2.0f * PI * float(j) / float(nbrdedivhorizontale); // de 0 à 2π
-
-            // Coordonnées sphériques
-            float x = sin(phi) * cos(theta);
-            float y = cos(phi);
-            float z = sin(phi) * sin(theta);
+    const size_t rowVerts = nbrdedivhorizontale + 1;
+    mesh->m_vertexPositions.resize(3 * (nbrdedivverticale + 1) * rowVerts);
+    mesh->m_vertexNormals.resize(mesh->m_vertexPositions.size());
+    mesh->m_vertexTexCoords.resize(2 * (nbrdedivverticale + 1) * rowVerts);
+    mesh->m_triangleIndices.resize(6 * nbrdedivverticale * nbrdedivhorizontale);
 
-            mesh->m_vertexPositions.push_back(x);
-            mesh->m_vertexPositions.push_back(y);
-            mesh->m_vertexPositions.push_back(z);
+    // --- Génération des sommets, une ligne de latitude par itération ---
+    JobSystem::shared().parallelFor(nbrdedivverticale + 1, kRowsPerJob, [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            float phi = PI * float(i) / float(nbrdedivverticale); // de 0 à π
+            for (size_t j = 0; j <= nbrdedivhorizontale; ++j) {
+                float theta = 2.0f * PI * float(j) / float(nbrdedivhorizontale); // de 0 à 2π
 
-            // Normales (identiques à la position car sphère unitaire)
-            mesh->m_vertexNormals.push_back(x);
-            mesh->m_vertexNormals.push_back(y);
-            mesh->m_vertexNormals.push_back(z);
+                // Coordonnées sphériques
+                float x = sin(phi) * cos(theta);
+                float y = cos(phi);
+                float z = sin(phi) * sin(theta);
 
-            float u = float(j) / float(nbrdedivhorizontale);
-            float v = float(i) / float(nbrdedivverticale);
-
-            mesh->m_vertexTexCoords.push_back(u);
-            mesh->m_vertexTexCoords.push_back(v);
+                const size_t v = i * rowVerts + j;
+                mesh->m_vertexPositions[3 * v] = x;
+                mesh->m_vertexPositions[3 * v + 1] = y;
+                mesh->m_vertexPositions[3 * v + 2] = z;
 
+                // Normales (identiques à la position car sphère unitaire)
+                mesh->m_vertexNormals[3 * v] = x;
+                mesh->m_vertexNormals[3 * v + 1] = y;
+                mesh->m_vertexNormals[3 * v + 2] = z;
 
+                mesh->m_vertexTexCoords[2 * v] = float(j) / float(nbrdedivhorizontale);
+                mesh->m_vertexTexCoords[2 * v + 1] = float(i) / float(nbrdedivverticale);
+            }
         }
-    }
+    });
 
-    for (size_t i = 0; i < nbrdedivverticale; ++i) {
-        for (size_t j = 0; j < nbrdedivhorizontale; ++j) {
-            unsigned int first  = i * (nbrdedivhorizontale + 1) + j;
-            unsigned int second = first + nbrdedivhorizontale + 1;
+    JobSystem::shared().parallelFor(nbrdedivverticale, kRowsPerJob, [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            for (size_t j = 0; j < nbrdedivhorizontale; ++j) {
+                unsigned int first  = i * (nbrdedivhorizontale + 1) + j;
+                unsigned int second = first + nbrdedivhorizontale + 1;
 
-            mesh->m_triangleIndices.push_back(first);
-            mesh->m_triangleIndices.push_back(first + 1);
-            mesh->m_triangleIndices.push_back(second);
-
-            mesh->m_triangleIndices.push_back(second);
-            mesh->m_triangleIndices.push_back(first + 1);
-            mesh->m_triangleIndices.push_back(second + 1);
+                unsigned int *tri = &mesh->m_triangleIndices[6 * (i * nbrdedivhorizontale + j)];
+                tri[0] = first;
+                tri[1] = first + 1;
+                tri[2] = second;
 
+                tri[3] = second;
+                tri[4] = first + 1;
+                tri[5] = second + 1;
+            }
         }
-    }
+    });
     std::vector<float> g_vertexColors;
     g_vertexColors = { // the array of vertex colors [r0, g0, b0, r1, g1, b1, ...]
         1.f, 0.f, 0.f,
@@ -61,70 +77,336 @@ std::shared_ptr<Mesh> Mesh::genSphere(const size_t resolution) {
 
     return mesh;
 }
-void Mesh::init() {
+
+// Ajoute un sommet de la sphère unité (normale = position).
+static unsigned int addUnitVertex(std::vector<float> &positions, std::vector<float> &normals,
+                                  const glm::vec3 &p) {
+    const glm::vec3 n = glm::normalize(p);
+    positions.insert(positions.end(), { n.x, n.y, n.z });
+    normals.insert(normals.end(), { n.x, n.y, n.z });
+    return unsigned(positions.size() / 3 - 1);
+}
+
+std::shared_ptr<Mesh> Mesh::genIcosphere(const size_t subdivisions) {
+    auto mesh = std::make_shared<Mesh>();
+    std::vector<float> &pos = mesh->m_vertexPositions;
+    std::vector<unsigned int> &tri = mesh->m_triangleIndices;
+
+    // --- Icosaèdre : 12 sommets, 20 faces ---
+    const float t = 0.5f * (1.f + std::sqrt(5.f));
+    const glm::vec3 corners[12] = {
+        glm::vec3(-1, t, 0), glm::vec3(1, t, 0), glm::vec3(-1, -t, 0), glm::vec3(1, -t, 0),
+        glm::vec3(0, -1, t), glm::vec3(0, 1, t), glm::vec3(0, -1, -t), glm::vec3(0, 1, -t),
+        glm::vec3(t, 0, -1), glm::vec3(t, 0, 1), glm::vec3(-t, 0, -1), glm::vec3(-t, 0, 1)
+    };
+    for (int i = 0; i < 12; ++i)
+        addUnitVertex(pos, mesh->m_vertexNormals, corners[i]);
+    tri = { 0, 11, 5,  0, 5, 1,  0, 1, 7,  0, 7, 10,  0, 10, 11,
+            1, 5, 9,  5, 11, 4,  11, 10, 2,  10, 7, 6,  7, 1, 8,
+            3, 9, 4,  3, 4, 2,  3, 2, 6,  3, 6, 8,  3, 8, 9,
+            4, 9, 5,  2, 4, 11,  6, 2, 10,  8, 6, 7,  9, 8, 1 };
+
+    // --- Subdivision : chaque arête n'est coupée qu'une fois grâce au cache ---
+    for (size_t level = 0; level < subdivisions; ++level) {
+        std::unordered_map<uint64_t, unsigned int> midpoints;
+        midpoints.reserve(tri.size());
+        auto midpoint = [&](unsigned int a, unsigned int b) {
+            const uint64_t key = (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+            auto it = midpoints.find(key);
+            if (it != midpoints.end())
+                return it->second;
+            const glm::vec3 pa(pos[3 * a], pos[3 * a + 1], pos[3 * a + 2]);
+            const glm::vec3 pb(pos[3 * b], pos[3 * b + 1], pos[3 * b + 2]);
+            const unsigned int m = addUnitVertex(pos, mesh->m_vertexNormals, pa + pb);
+            midpoints[key] = m;
+            return m;
+        };
+
+        std::vector<unsigned int> finer;
+        finer.reserve(4 * tri.size());
+        for (size_t k = 0; k < tri.size(); k += 3) {
+            const unsigned int a = tri[k], b = tri[k + 1], c = tri[k + 2];
+            const unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            finer.insert(finer.end(), { a, ab, ca,  b, bc, ab,  c, ca, bc,  ab, bc, ca });
+        }
+        tri.swap(finer);
+    }
+
+    // --- Coordonnées de texture équirectangulaires, comme genSphere ---
+    const float PI = 3.14159265359f;
+    const size_t baseCount = pos.size() / 3;
+    for (size_t v = 0; v < baseCount; ++v) {
+        float theta = std::atan2(pos[3 * v + 2], pos[3 * v]);
+        if (theta < 0.f)
+            theta += 2.f * PI;
+        mesh->m_vertexTexCoords.push_back(theta / (2.f * PI));
+        mesh->m_vertexTexCoords.push_back(std::acos(glm::clamp(pos[3 * v + 1], -1.f, 1.f)) / PI);
+    }
+    // Un triangle à cheval sur la couture u = 0 / 1 reçoit des copies de ses
+    // sommets côté u < 0.5, décalées de u + 1.
+    std::unordered_map<unsigned int, unsigned int> seamCopies;
+    for (size_t k = 0; k < tri.size(); k += 3) {
+        float uMin = 1.f, uMax = 0.f;
+        for (int c = 0; c < 3; ++c) {
+            uMin = std::min(uMin, mesh->m_vertexTexCoords[2 * tri[k + c]]);
+            uMax = std::max(uMax, mesh->m_vertexTexCoords[2 * tri[k + c]]);
+        }
+        if (uMax - uMin <= 0.5f)
+            continue;
+        for (int c = 0; c < 3; ++c) {
+            const unsigned int v = tri[k + c];
+            if (mesh->m_vertexTexCoords[2 * v] >= 0.5f)
+                continue;
+            auto it = seamCopies.find(v);
+            if (it == seamCopies.end()) {
+                const glm::vec3 p(pos[3 * v], pos[3 * v + 1], pos[3 * v + 2]);
+                const unsigned int copy = addUnitVertex(pos, mesh->m_vertexNormals, p);
+                mesh->m_vertexTexCoords.push_back(mesh->m_vertexTexCoords[2 * v] + 1.f);
+                mesh->m_vertexTexCoords.push_back(mesh->m_vertexTexCoords[2 * v + 1]);
+                it = seamCopies.insert(std::make_pair(v, copy)).first;
+            }
+            tri[k + c] = it->second;
+        }
+    }
+    return mesh;
+}
+
+std::shared_ptr<Mesh> Mesh::genCubeSphere(const size_t divisions) {
+    auto mesh = std::make_shared<Mesh>();
+    const size_t n = std::max<size_t>(divisions, 1);
+
+    // Pour chaque face : normale sortante, puis axes u et v du carré [-1, 1]²
+    const glm::vec3 faces[6][3] = {
+        { glm::vec3( 1, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0) },
+        { glm::vec3(-1, 0, 0), glm::vec3(0, 0,  1), glm::vec3(0, 1, 0) },
+        { glm::vec3(0,  1, 0), glm::vec3(1, 0,  0), glm::vec3(0, 0, -1) },
+        { glm::vec3(0, -1, 0), glm::vec3(1, 0,  0), glm::vec3(0, 0,  1) },
+        { glm::vec3(0, 0,  1), glm::vec3(1, 0,  0), glm::vec3(0, 1, 0) },
+        { glm::vec3(0, 0, -1), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0) }
+    };
+    for (int f = 0; f < 6; ++f) {
+        // les arêtes sont dupliquées : chaque face a ses propres UV dans [0, 1]²
+        const unsigned int first = unsigned(mesh->m_vertexPositions.size() / 3);
+        for (size_t i = 0; i <= n; ++i) {
+            const float tv = float(i) / float(n);
+            for (size_t j = 0; j <= n; ++j) {
+                const float tu = float(j) / float(n);
+                addUnitVertex(mesh->m_vertexPositions, mesh->m_vertexNormals,
+                              faces[f][0] + (2.f * tu - 1.f) * faces[f][1] + (2.f * tv - 1.f) * faces[f][2]);
+                mesh->m_vertexTexCoords.push_back(tu);
+                mesh->m_vertexTexCoords.push_back(tv);
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                const unsigned int a = first + unsigned(i * (n + 1) + j), b = a + 1;
+                const unsigned int c = a + unsigned(n + 1), d = c + 1;
+                mesh->m_triangleIndices.insert(mesh->m_triangleIndices.end(), { a, b, d,  a, d, c });
+            }
+        }
+    }
+    return mesh;
+}
+
+float Mesh::sphereError() const {
+    // Pour des sommets sur la sphère unité, le point du triangle le plus
+    // proche du centre est (au plus) le pied de la normale passant par l'origine.
+    float error = 0.f;
+    for (size_t k = 0; k + 2 < m_triangleIndices.size(); k += 3) {
+        const float *a = &m_vertexPositions[3 * m_triangleIndices[k]];
+        const float *b = &m_vertexPositions[3 * m_triangleIndices[k + 1]];
+        const float *c = &m_vertexPositions[3 * m_triangleIndices[k + 2]];
+        const glm::vec3 pa(a[0], a[1], a[2]), pb(b[0], b[1], b[2]), pc(c[0], c[1], c[2]);
+        const glm::vec3 cross = glm::cross(pb - pa, pc - pa);
+        const float area = glm::length(cross);
+        if (area < 1e-12f)
+            continue; // triangles dégénérés des pôles de genSphere
+        error = std::max(error, 1.f - std::abs(glm::dot(cross / area, pa)));
+    }
+    return error;
+}
+
+// Demi-flottant IEEE (arrondi au plus proche) ; les valeurs trop petites
+// deviennent 0, ce qui suffit pour des positions de maillage.
+static uint16_t toHalf(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    const uint16_t sign = uint16_t((bits >> 16) & 0x8000u);
+    const int exponent = int((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    if (exponent <= 0)
+        return sign;
+    if (exponent >= 31)
+        return uint16_t(sign | 0x7C00u);
+    mantissa += 0x1000u; // arrondi des 13 bits abandonnés
+    if (mantissa & 0x800000u)
+        return uint16_t(sign | (exponent + 1 >= 31 ? 0x7C00u : uint32_t(exponent + 1) << 10));
+    return uint16_t(sign | uint32_t(exponent) << 10 | mantissa >> 13);
+}
+
+static uint32_t toSnorm10(float x) {
+    const float c = std::min(std::max(x, -1.f), 1.f);
+    return uint32_t(int32_t(std::round(c * 511.f))) & 0x3FFu;
+}
+
+static uint16_t toUnorm16(float x) {
+    const float c = std::min(std::max(x, 0.f), 1.f);
+    return uint16_t(std::round(c * 65535.f));
+}
+
+// Permute un attribut de composantes flottantes par sommet : out[remap[v]] = in[v].
+static void remapAttribute(std::vector<float> &values, size_t components,
+                           const std::vector<int> &remap, size_t newVertexCount) {
+    if (values.empty())
+        return;
+    std::vector<float> out(components * newVertexCount);
+    for (size_t v = 0; v < remap.size(); ++v) {
+        if (remap[v] < 0)
+            continue;
+        std::copy(values.begin() + components * v, values.begin() + components * (v + 1),
+                  out.begin() + components * size_t(remap[v]));
+    }
+    values.swap(out);
+}
+
+Mesh::CacheStats Mesh::optimize() {
+    CacheStats stats;
+    const size_t vertexCount = m_vertexPositions.size() / 3;
+    stats.acmrBefore = averageCacheMissRatio(m_triangleIndices);
+    stats.atvrBefore = averageTransformToVertexRatio(m_triangleIndices, vertexCount);
+
+    optimizeVertexCache(m_triangleIndices, vertexCount);
+    stats.overdrawClusters = optimizeOverdraw(m_triangleIndices, m_vertexPositions);
+    size_t newVertexCount = 0;
+    const std::vector<int> remap = optimizeVertexFetch(m_triangleIndices, vertexCount, newVertexCount);
+    remapAttribute(m_vertexPositions, 3, remap, newVertexCount);
+    remapAttribute(m_vertexNormals, 3, remap, newVertexCount);
+    remapAttribute(m_vertexTexCoords, 2, remap, newVertexCount);
+
+    stats.acmrAfter = averageCacheMissRatio(m_triangleIndices);
+    stats.atvrAfter = averageTransformToVertexRatio(m_triangleIndices, newVertexCount);
+    m_optimized = true;
+    return stats;
+}
+
+void Mesh::init(bool releaseCpuData) {
+    if (!m_optimized)
+        optimize();
+    // --- Sommets entrelacés et quantifiés ---
+    const size_t vertexCount = m_vertexPositions.size() / 3;
+    std::vector<PackedVertex> vertices(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        PackedVertex &pv = vertices[v];
+        for (int c = 0; c < 3; ++c)
+            pv.position[c] = toHalf(m_vertexPositions[3 * v + c]);
+        pv.position[3] = toHalf(1.f);
+        pv.normal = toSnorm10(m_vertexNormals[3 * v]) | toSnorm10(m_vertexNormals[3 * v + 1]) << 10
+                  | toSnorm10(m_vertexNormals[3 * v + 2]) << 20;
+        pv.texCoord[0] = toUnorm16(m_vertexTexCoords[2 * v] / kTexCoordRange);
+        pv.texCoord[1] = toUnorm16(m_vertexTexCoords[2 * v + 1] / kTexCoordRange);
+    }
+
     // Crée et active le VAO (Vertex Array Object)
     glGenVertexArrays(1, &m_vao);
     glBindVertexArray(m_vao);
 
-    // --- Positions des sommets ---
-    glGenBuffers(1, &m_posVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 sizeof(float) * m_vertexPositions.size(),
-                 m_vertexPositions.data(),
-                 GL_STATIC_DRAW);
-    glVertexAttribPointer(
-        0,                // location = 0 dans le shader
-        3,                // 3 composantes (x, y, z)
-        GL_FLOAT,         // type
-        GL_FALSE,         // ne pas normaliser
-        3 * sizeof(float),// taille d’un vertex
-        (void*)0);        // offset
+    glGenBuffers(1, &m_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
+    // location 0 : position (x, y, z) en demi-flottants
+    glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
     glEnableVertexAttribArray(0);
-
-    // --- Normales des sommets ---
-    glGenBuffers(1, &m_normalVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_normalVbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 sizeof(float) * m_vertexNormals.size(),
-                 m_vertexNormals.data(),
-                 GL_STATIC_DRAW);
-    glVertexAttribPointer(
-        1,                // location = 1 dans le shader
-        3,                // 3 composantes (nx, ny, nz)
-        GL_FLOAT,
-        GL_FALSE,
-        3 * sizeof(float),
-        (void*)0);
+    // location 1 : normale, 10 bits signés normalisés par composante
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
     glEnableVertexAttribArray(1);
+    // location 2 : coordonnées de texture, 16 bits non signés normalisés
+    glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoord));
+    glEnableVertexAttribArray(2);
 
-    // --- Indices des triangles ---
+    // --- Indices des triangles, sur 16 bits quand c'est possible ---
+    m_indexCount = m_triangleIndices.size();
     glGenBuffers(1, &m_ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 sizeof(unsigned int) * m_triangleIndices.size(),
-                 m_triangleIndices.data(),
-                 GL_STATIC_DRAW);
-
-
-    glGenBuffers(1, &m_texCoordVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_texCoordVbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 sizeof(float) * m_vertexTexCoords.size(),
-                 m_vertexTexCoords.data(),
-                 GL_STATIC_DRAW);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0); // désactive le VAO
+    size_t indexBytes;
+    if (vertexCount <= 65536) {
+        const std::vector<uint16_t> shortIndices(m_triangleIndices.begin(), m_triangleIndices.end());
+        m_indexType = GL_UNSIGNED_SHORT;
+        indexBytes = sizeof(uint16_t) * shortIndices.size();
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, shortIndices.data(), GL_STATIC_DRAW);
+    } else {
+        m_indexType = GL_UNSIGNED_INT;
+        indexBytes = sizeof(unsigned int) * m_triangleIndices.size();
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, m_triangleIndices.data(), GL_STATIC_DRAW);
+    }
+    m_gpuVertexCount = vertexCount;
+    m_gpuBytes = sizeof(PackedVertex) * vertexCount + indexBytes;
 
+    // --- Attributs par instance (vide tant que uploadInstances n'a rien envoyé) ---
+    glGenBuffers(1, &m_instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    pointInstanceAttributes(0);
+    for (GLuint loc = 3; loc <= 7; ++loc) { // mat4 sur 3 à 6 (4 locations), vec3 sur 7
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
 
+    glBindVertexArray(0); // désactive le VAO
 
+    if (releaseCpuData) {
+        // swap plutôt que clear : rend vraiment la mémoire
+        std::vector<float>().swap(m_vertexPositions);
+        std::vector<float>().swap(m_vertexNormals);
+        std::vector<float>().swap(m_vertexTexCoords);
+        std::vector<unsigned int>().swap(m_triangleIndices);
+    }
 }
 
 
 void Mesh::render() {
     glBindVertexArray(m_vao); //je dois rebind car g desactive le vao dans init
-    glDrawElements(GL_TRIANGLES, m_triangleIndices.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, GLsizei(m_indexCount), m_indexType, 0);
     glBindVertexArray(0); //je desactive pr eviter les erreures.
 }
+
+void Mesh::renderInstanced(const InstanceData *instances, size_t count) {
+    uploadInstances(instances, count);
+    drawInstances(0, count);
+}
+
+void Mesh::uploadInstances(const InstanceData *instances, size_t count) {
+    if (count == 0)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    if (count > m_instanceCapacity) {
+        // croissance géométrique pour ne pas réallouer à chaque nouvel astéroïde
+        m_instanceCapacity = std::max(count, 2 * m_instanceCapacity);
+    }
+    // orphelinage : le driver n'attend pas la fin du draw précédent
+    glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * m_instanceCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(InstanceData) * count, instances);
+}
+
+void Mesh::drawInstances(size_t first, size_t count) {
+    if (count == 0)
+        return;
+
+    glBindVertexArray(m_vao);
+    if (first != m_instanceFirst) {
+        // pas de baseInstance en GL 3.3 : on décale les pointeurs du VAO
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+        pointInstanceAttributes(first);
+    }
+    glDrawElementsInstanced(GL_TRIANGLES, GLsizei(m_indexCount), m_indexType, 0, GLsizei(count));
+}
+
+void Mesh::pointInstanceAttributes(size_t first) {
+    // m_vao et m_instanceVbo doivent être liés
+    const size_t base = first * sizeof(InstanceData);
+    for (GLuint col = 0; col < 4; ++col)
+        glVertexAttribPointer(3 + col, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(base + offsetof(InstanceData, model) + col * sizeof(glm::vec4)));
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(base + offsetof(InstanceData, layer)));
+    m_instanceFirst = first;
+}
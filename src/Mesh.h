@@ -5,13 +5,67 @@
 #include <vector>
 #include <glad/gl.h>
 #include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
 
 
 class Mesh {
 public:
-    void init();
+    // Données par instance, lues par le vertex shader (locations 3 à 7)
+    struct InstanceData {
+        glm::mat4 model;
+        float layer = 0.f;    // couche de texture
+        float minLod = 0.f;   // niveau de mipmap le plus fin déjà chargé pour la couche
+        float virtualLayer = -1.f; // couche de VirtualTexture, -1 : texture classique
+    };
+
+    // Qualité de l'ordre des triangles pour le cache de sommets (voir MeshOptimizer.h).
+    struct CacheStats {
+        float acmrBefore = 0.f, acmrAfter = 0.f;
+        float atvrBefore = 0.f, atvrAfter = 0.f;
+        size_t overdrawClusters = 0; // groupes réordonnés par optimizeOverdraw
+    };
+    // Réordonne les triangles (cache post-transformation, puis groupes
+    // contre le surdessin) puis les sommets (lecture séquentielle). Appelé par init() si ce n'est pas déjà fait.
+    CacheStats optimize();
+
+    // Envoie le maillage au GPU au format compact (voir PackedVertex).
+    // releaseCpuData : libère ensuite les tableaux CPU, devenus inutiles
+    // pour le rendu (sphereError et les générateurs en ont besoin avant).
+    void init(bool releaseCpuData = false);
     void render();
+    // Dessine toutes les instances en un seul glDrawElementsInstanced
+    void renderInstanced(const InstanceData *instances, size_t count);
+    // Variante en deux temps : un seul envoi par image, puis autant de
+    // draws que nécessaire sur des plages [first, first + count) du tampon.
+    void uploadInstances(const InstanceData *instances, size_t count);
+    void drawInstances(size_t first, size_t count);
     static std::shared_ptr<Mesh> genSphere(size_t resolution = 16);
+    // Icosaèdre subdivisé : sommets répartis presque uniformément, UV
+    // équirectangulaires comme genSphere (sommets dupliqués sur la couture).
+    static std::shared_ptr<Mesh> genIcosphere(size_t subdivisions = 3);
+    // Cube de divisions x divisions carrés par face, normalisé sur la
+    // sphère ; chaque face a ses propres UV dans [0, 1]².
+    static std::shared_ptr<Mesh> genCubeSphere(size_t divisions = 16);
+
+    size_t vertexCount() const { return m_vertexPositions.empty() ? m_gpuVertexCount : m_vertexPositions.size() / 3; }
+    size_t triangleCount() const { return m_triangleIndices.empty() ? m_indexCount / 3 : m_triangleIndices.size() / 3; }
+    // Octets occupés sur le GPU par les sommets et les indices.
+    size_t gpuBytes() const { return m_gpuBytes; }
+    // Écart maximal entre le maillage et la sphère unité qu'il approche.
+    float sphereError() const;
+
+    // Sommet entrelacé de 16 octets (32 en flottants séparés) :
+    // position en demi-flottants, normale en GL_INT_2_10_10_10_REV,
+    // coordonnées de texture en unorm16 sur [0, kTexCoordRange].
+    struct PackedVertex {
+        uint16_t position[4];  // x, y, z, remplissage
+        uint32_t normal;
+        uint16_t texCoord[2];
+    };
+    // Les copies de la couture de genIcosphere vont jusqu'à u = 1.5 ; le
+    // vertex shader remultiplie par cette constante.
+    static constexpr float kTexCoordRange = 2.f;
 
 private:
     std::vector<float> m_vertexPositions;
@@ -20,12 +74,20 @@ private:
     std::vector<float> g_vertexColors;
     std::vector<float> m_vertexTexCoords;
 
-    GLuint m_texCoordVbo = 0;
     GLuint m_vao = 0;
-    GLuint m_posVbo = 0;
-    GLuint m_normalVbo = 0;
+    GLuint m_vbo = 0;              // sommets entrelacés (PackedVertex)
     GLuint m_ibo = 0;
+    GLenum m_indexType = GL_UNSIGNED_INT;  // GL_UNSIGNED_SHORT si moins de 65536 sommets
+    size_t m_indexCount = 0;
+    size_t m_gpuVertexCount = 0;
+    size_t m_gpuBytes = 0;
+    bool m_optimized = false;
     GLuint g_colVbo=0;
+    GLuint m_instanceVbo = 0;
+    size_t m_instanceCapacity = 0; // en nombre d'instances
+    size_t m_instanceFirst = 0;    // première instance pointée par les attributs 3 à 7
+
+    void pointInstanceAttributes(size_t first);
 };
 
 #endif // MESH_H
@@ -0,0 +1,288 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Paramètres de Forsyth ("Linear-Speed Vertex Cache Optimisation")
+static const int kLruSize = 32;
+static const float kCacheDecayPower = 1.5f;
+static const float kLastTriangleScore = 0.75f;
+static const float kValenceBoostScale = 2.0f;
+static const float kValenceBoostPower = 0.5f;
+
+// Cache FIFO de sommets transformés, simulé triangle par triangle.
+class FifoCache {
+public:
+    explicit FifoCache(size_t size) : m_slots(size, ~0u) {}
+    void clear() {
+        std::fill(m_slots.begin(), m_slots.end(), ~0u);
+        m_head = 0;
+    }
+    // Nombre de sommets de tri absents du cache ; les y ajoute.
+    int misses(const unsigned int *tri) {
+        int count = 0;
+        for (int c = 0; c < 3; ++c) {
+            if (std::find(m_slots.begin(), m_slots.end(), tri[c]) != m_slots.end())
+                continue;
+            m_slots[m_head] = tri[c];
+            m_head = (m_head + 1) % m_slots.size();
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    std::vector<unsigned int> m_slots;
+    size_t m_head = 0;
+};
+
+static float vertexScore(int cachePosition, int liveTriangles) {
+    if (liveTriangles == 0)
+        return -1.f;  // plus aucun triangle à émettre
+
+    float score = 0.f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // sommets du dernier triangle : bonus fixe, pour éviter de repartir dessus
+            score = kLastTriangleScore;
+        } else {
+            const float scaler = 1.f / float(kLruSize - 3);
+            score = std::pow(1.f - float(cachePosition - 3) * scaler, kCacheDecayPower);
+        }
+    }
+    // favorise les sommets qui n'ont presque plus de triangles : on les termine
+    return score + kValenceBoostScale * std::pow(float(liveTriangles), -kValenceBoostPower);
+}
+
+void optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // --- Adjacence sommet -> triangles, en tableau compact ---
+    std::vector<int> liveTriangles(vertexCount, 0);
+    for (size_t k = 0; k < triangleCount * 3; ++k)
+        ++liveTriangles[indices[k]];
+    std::vector<size_t> adjacencyStart(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyStart[v + 1] = adjacencyStart[v] + size_t(liveTriangles[v]);
+    std::vector<unsigned int> adjacency(adjacencyStart.back());
+    {
+        std::vector<size_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t)
+            for (int c = 0; c < 3; ++c)
+                adjacency[fill[indices[3 * t + c]]++] = unsigned(t);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        score[v] = vertexScore(-1, liveTriangles[v]);
+    std::vector<float> triangleScore(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+        triangleScore[t] = score[indices[3 * t]] + score[indices[3 * t + 1]] + score[indices[3 * t + 2]];
+    std::vector<unsigned char> emitted(triangleCount, 0);
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    std::vector<unsigned int> lru, nextLru;
+    lru.reserve(kLruSize + 3);
+    nextLru.reserve(kLruSize + 3);
+
+    size_t scanCursor = 0;  // pour repartir quand le cache n'offre plus rien
+    long best = -1;
+    while (output.size() < indices.size()) {
+        if (best < 0) {
+            float bestScore = -1e30f;
+            for (size_t t = scanCursor; t < triangleCount; ++t) {
+                if (emitted[t])
+                    continue;
+                if (best < 0)
+                    scanCursor = t;  // premier non émis
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = long(t);
+                }
+                // un triangle tout neuf suffit : inutile de parcourir tout le reste
+                if (bestScore > 0.f && t > scanCursor + 256)
+                    break;
+            }
+        }
+
+        const unsigned int *tri = &indices[3 * size_t(best)];
+        emitted[best] = 1;
+        output.insert(output.end(), tri, tri + 3);
+
+        // retire le triangle de l'adjacence de ses sommets
+        for (int c = 0; c < 3; ++c) {
+            const unsigned int v = tri[c];
+            unsigned int *begin = &adjacency[adjacencyStart[v]];
+            unsigned int *end = begin + liveTriangles[v];
+            *std::find(begin, end, unsigned(best)) = end[-1];
+            --liveTriangles[v];
+        }
+
+        // LRU : le triangle émis en tête, puis l'ancien contenu
+        nextLru.assign(tri, tri + 3);
+        for (size_t k = 0; k < lru.size(); ++k) {
+            const unsigned int v = lru[k];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                nextLru.push_back(v);
+        }
+        for (size_t k = 0; k < nextLru.size(); ++k) {
+            const unsigned int v = nextLru[k];
+            cachePosition[v] = int(k) < kLruSize ? int(k) : -1;
+            score[v] = vertexScore(cachePosition[v], liveTriangles[v]);
+        }
+
+        // seuls les triangles touchant le cache ont changé de score, y compris
+        // ceux des sommets qui viennent d'en sortir (fin de nextLru)
+        best = -1;
+        float bestScore = -1e30f;
+        for (size_t k = 0; k < nextLru.size(); ++k) {
+            const unsigned int v = nextLru[k];
+            for (size_t a = adjacencyStart[v]; a < adjacencyStart[v] + size_t(liveTriangles[v]); ++a) {
+                const unsigned int t = adjacency[a];
+                const float s = score[indices[3 * t]] + score[indices[3 * t + 1]] + score[indices[3 * t + 2]];
+                triangleScore[t] = s;
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = long(t);
+                }
+            }
+        }
+        if (nextLru.size() > size_t(kLruSize))
+            nextLru.resize(kLruSize);
+        lru.swap(nextLru);
+    }
+    indices.swap(output);
+}
+
+size_t optimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<float> &positions,
+                        float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return 0;
+
+    // --- Frontières dures : triangles dont les 3 sommets manquent au cache,
+    // l'ordre y repart de zéro et on peut couper sans rien perdre ---
+    FifoCache cache(kVertexCacheSize);
+    std::vector<size_t> hard;
+    for (size_t t = 0; t < triangleCount; ++t)
+        if (cache.misses(&indices[3 * t]) == 3 || t == 0)
+            hard.push_back(t);
+    hard.push_back(triangleCount);
+
+    // --- Frontières souples : dans un groupe dur, on coupe dès que l'ACMR
+    // courant (cache vidé au début du sous-groupe) reste sous threshold fois
+    // celui du groupe entier ---
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hard.size(); ++h) {
+        const size_t begin = hard[h], end = hard[h + 1];
+        cache.clear();
+        size_t groupMisses = 0;
+        for (size_t t = begin; t < end; ++t)
+            groupMisses += size_t(cache.misses(&indices[3 * t]));
+        const float groupAcmr = float(groupMisses) / float(end - begin);
+
+        cache.clear();
+        clusters.push_back(begin);
+        size_t misses = 0, count = 0;
+        for (size_t t = begin; t < end; ++t) {
+            misses += size_t(cache.misses(&indices[3 * t]));
+            ++count;
+            if (t + 1 < end && float(misses) <= threshold * groupAcmr * float(count)) {
+                clusters.push_back(t + 1);
+                cache.clear();
+                misses = count = 0;
+            }
+        }
+    }
+    const size_t clusterCount = clusters.size();
+    clusters.push_back(triangleCount);
+
+    // --- Tri : produit scalaire entre la normale moyenne du groupe et la
+    // direction centre du maillage -> centre du groupe, le plus grand d'abord ---
+    const size_t vertexCount = positions.size() / 3;
+    double meshCenter[3] = { 0.0, 0.0, 0.0 };
+    for (size_t v = 0; v < vertexCount; ++v)
+        for (int c = 0; c < 3; ++c)
+            meshCenter[c] += positions[3 * v + c];
+    for (int c = 0; c < 3; ++c)
+        meshCenter[c] /= double(std::max<size_t>(vertexCount, 1));
+
+    std::vector<float> sortKey(clusterCount);
+    for (size_t k = 0; k < clusterCount; ++k) {
+        double center[3] = { 0.0, 0.0, 0.0 }, normal[3] = { 0.0, 0.0, 0.0 }, area = 0.0;
+        for (size_t t = clusters[k]; t < clusters[k + 1]; ++t) {
+            const float *p0 = &positions[3 * indices[3 * t]];
+            const float *p1 = &positions[3 * indices[3 * t + 1]];
+            const float *p2 = &positions[3 * indices[3 * t + 2]];
+            const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            const double n[3] = { e1[1] * e2[2] - e1[2] * e2[1],
+                                  e1[2] * e2[0] - e1[0] * e2[2],
+                                  e1[0] * e2[1] - e1[1] * e2[0] };
+            const double a = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);  // 2 x aire
+            for (int c = 0; c < 3; ++c) {
+                center[c] += a * (p0[c] + p1[c] + p2[c]) / 3.0;
+                normal[c] += n[c];  // déjà pondérée par l'aire
+            }
+            area += a;
+        }
+        const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        double key = 0.0;
+        if (area > 0.0 && length > 0.0)
+            for (int c = 0; c < 3; ++c)
+                key += (center[c] / area - meshCenter[c]) * normal[c] / length;
+        sortKey[k] = float(key);
+    }
+
+    std::vector<size_t> order(clusterCount);
+    for (size_t k = 0; k < clusterCount; ++k)
+        order[k] = k;
+    std::stable_sort(order.begin(), order.end(),
+                     [&sortKey](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (size_t k = 0; k < clusterCount; ++k)
+        output.insert(output.end(), indices.begin() + 3 * clusters[order[k]],
+                      indices.begin() + 3 * clusters[order[k] + 1]);
+    indices.swap(output);
+    return clusterCount;
+}
+
+std::vector<int> optimizeVertexFetch(std::vector<unsigned int> &indices, size_t vertexCount,
+                                     size_t &newVertexCount) {
+    std::vector<int> remap(vertexCount, -1);
+    newVertexCount = 0;
+    for (size_t k = 0; k < indices.size(); ++k) {
+        int &target = remap[indices[k]];
+        if (target < 0)
+            target = int(newVertexCount++);
+        indices[k] = unsigned(target);
+    }
+    return remap;
+}
+
+static size_t countCacheMisses(const std::vector<unsigned int> &indices, size_t cacheSize) {
+    FifoCache cache(cacheSize);
+    size_t misses = 0;
+    for (size_t k = 0; k + 2 < indices.size(); k += 3)
+        misses += size_t(cache.misses(&indices[k]));
+    return misses;
+}
+
+float averageCacheMissRatio(const std::vector<unsigned int> &indices, size_t cacheSize) {
+    if (indices.size() < 3)
+        return 0.f;
+    return float(countCacheMisses(indices, cacheSize)) / float(indices.size() / 3);
+}
+
+float averageTransformToVertexRatio(const std::vector<unsigned int> &indices, size_t vertexCount,
+                                    size_t cacheSize) {
+    if (vertexCount == 0)
+        return 0.f;
+    return float(countCacheMisses(indices, cacheSize)) / float(vertexCount);
+}
@@ -0,0 +1,127 @@
+#include "MipChain.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const size_t kRowsPerJob = 16;
+
+bool parseMipMode(const std::string &name, MipMode &mode) {
+    if (name == "none") mode = MipMode::None;
+    else if (name == "gpu") mode = MipMode::Gpu;
+    else if (name == "cpu") mode = MipMode::Cpu;
+    else return false;
+    return true;
+}
+
+const char *mipModeName(MipMode mode) {
+    switch (mode) {
+    case MipMode::None: return "none";
+    case MipMode::Gpu: return "gpu";
+    case MipMode::Cpu: return "cpu";
+    }
+    return "?";
+}
+
+const char *mipFilterName(MipFilter filter) {
+    return filter == MipFilter::Box ? "box" : "tent";
+}
+
+int mipLevelCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++levels;
+    }
+    return levels;
+}
+
+static float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static unsigned char linearToSrgb8(float c) {
+    c = std::min(std::max(c, 0.f), 1.f);
+    const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+    return (unsigned char)(s * 255.f + 0.5f);
+}
+
+// Noyau séparable : taps poids, le premier sur le texel situé first cases
+// après celui juste à gauche du centre de l'échantillon.
+struct Kernel {
+    int taps, first;
+    float weights[4];
+};
+static const Kernel kTent = { 4, -1, { 1.f / 8.f, 3.f / 8.f, 3.f / 8.f, 1.f / 8.f } };
+static const Kernel kBox = { 2, 0, { 1.f / 2.f, 1.f / 2.f, 0.f, 0.f } };
+
+// Réduit src (w x h) de moitié : passe horizontale puis verticale.
+static void downsample(const std::vector<float> &src, int w, int h, int channels, bool wrapX,
+                       const Kernel &kernel, std::vector<float> &dst, int dw, int dh) {
+    // un axe déjà à 1 n'est pas réduit : il garde un seul échantillon
+    const float sx = float(w) / float(dw), sy = float(h) / float(dh);
+
+    std::vector<float> rows(size_t(dw) * h * channels);
+    JobSystem::shared().parallelFor(size_t(h), kRowsPerJob, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            for (int x = 0; x < dw; ++x) {
+                const int x0 = int(std::floor((float(x) + 0.5f) * sx - 0.5f)) + kernel.first;  // premier voisin
+                for (int c = 0; c < channels; ++c) {
+                    float sum = 0.f;
+                    for (int k = 0; k < kernel.taps; ++k) {
+                        int xi = x0 + k;
+                        xi = wrapX ? (xi % w + w) % w : std::min(std::max(xi, 0), w - 1);
+                        sum += kernel.weights[k] * src[(y * w + size_t(xi)) * channels + c];
+                    }
+                    rows[(y * dw + size_t(x)) * channels + c] = sum;
+                }
+            }
+        }
+    });
+
+    dst.assign(size_t(dw) * dh * channels, 0.f);
+    JobSystem::shared().parallelFor(size_t(dh), kRowsPerJob, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            const int y0 = int(std::floor((float(y) + 0.5f) * sy - 0.5f)) + kernel.first;
+            for (int k = 0; k < kernel.taps; ++k) {
+                const int yi = std::min(std::max(y0 + k, 0), h - 1);  // pôles : pas de repli
+                for (size_t i = 0; i < size_t(dw) * channels; ++i)
+                    dst[y * dw * channels + i] += kernel.weights[k] * rows[size_t(yi) * dw * channels + i];
+            }
+        }
+    });
+}
+
+std::vector<MipLevel> buildMipChain(const unsigned char *pixels, int width, int height,
+                                    int channels, bool wrapX, MipFilter filter) {
+    const bool srgb = filter == MipFilter::Tent;
+    const Kernel &kernel = srgb ? kTent : kBox;
+    float toLinear[256];
+    for (int i = 0; i < 256; ++i)
+        toLinear[i] = srgb ? srgbToLinear(float(i) / 255.f) : float(i) / 255.f;
+
+    std::vector<float> current(size_t(width) * height * channels), next;
+    for (size_t i = 0; i < current.size(); ++i)
+        current[i] = toLinear[pixels[i]];
+
+    std::vector<MipLevel> levels;
+    int w = width, h = height;
+    while (w > 1 || h > 1) {
+        const int dw = std::max(1, w / 2), dh = std::max(1, h / 2);
+        downsample(current, w, h, channels, wrapX, kernel, next, dw, dh);
+        current.swap(next);
+        w = dw;
+        h = dh;
+
+        MipLevel level;
+        level.width = w;
+        level.height = h;
+        level.pixels.resize(current.size());
+        for (size_t i = 0; i < current.size(); ++i)
+            level.pixels[i] = srgb ? linearToSrgb8(current[i])
+                                   : (unsigned char)(std::min(std::max(current[i], 0.f), 1.f) * 255.f + 0.5f);
+        levels.push_back(level);
+    }
+    return levels;
+}
@@ -0,0 +1,42 @@
+#ifndef MIPCHAIN_H
+#define MIPCHAIN_H
+
+#include <string>
+#include <vector>
+
+// Origine des niveaux de mipmap d'une texture.
+enum class MipMode {
+    None,  // niveau 0 seul, filtrage GL_LINEAR (ancien comportement, pour comparer)
+    Gpu,   // glGenerateMipmap (boîte 2x2 du driver)
+    Cpu    // buildMipChain : filtre plus large, en espace linéaire
+};
+
+// "none", "gpu" ou "cpu" ; renvoie false si le nom est inconnu.
+bool parseMipMode(const std::string &name, MipMode &mode);
+const char *mipModeName(MipMode mode);
+
+// Filtre de réduction de buildMipChain, à choisir selon le contenu de l'image.
+enum class MipFilter {
+    Tent,  // albédo sRGB : tente [1 3 3 1] / 8 en lumière linéaire
+    Box    // données (normales, hauteurs...) : moyenne 2x2 des valeurs brutes
+};
+
+const char *mipFilterName(MipFilter filter);
+
+struct MipLevel {
+    int width, height;
+    std::vector<unsigned char> pixels;  // channels octets par texel, lignes contiguës
+};
+
+// Nombre de niveaux d'une chaîne complète jusqu'à 1x1.
+int mipLevelCount(int width, int height);
+
+// Niveaux 1 à n-1 d'une image 8 bits (le niveau 0 n'est pas recopié).
+// Chaque niveau est filtré depuis le précédent, séparément en x et en y.
+// Tent travaille en lumière linéaire pour ne pas assombrir les contrastes ;
+// Box ne convertit rien, une normale ou une altitude n'est pas une couleur.
+// wrapX : l'image se referme horizontalement (cartes équirectangulaires).
+std::vector<MipLevel> buildMipChain(const unsigned char *pixels, int width, int height,
+                                    int channels, bool wrapX = true, MipFilter filter = MipFilter::Tent);
+
+#endif // MIPCHAIN_H
@@ -0,0 +1,195 @@
+#include "NBody.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const int kLeafSize = 8;   // corps par feuille avant subdivision
+static const int kMaxDepth = 32;  // garde-fou pour les corps confondus
+static const size_t kGrain = 256; // corps par tâche
+
+NBody::NBody() {}
+
+int NBody::add(const glm::vec3 &position, const glm::vec3 &velocity, float mass) {
+    m_x.push_back(position.x); m_y.push_back(position.y); m_z.push_back(position.z);
+    m_vx.push_back(velocity.x); m_vy.push_back(velocity.y); m_vz.push_back(velocity.z);
+    m_mass.push_back(mass);
+    m_acc.push_back(glm::vec3(0.f));
+    m_accValid = false;
+    return int(m_mass.size()) - 1;
+}
+
+void NBody::setAttractors(const std::vector<glm::vec3> &positions, const std::vector<float> &masses) {
+    m_attractorPos = positions;
+    m_attractorMass = masses;
+}
+
+void NBody::step(float dt) {
+    if (!m_accValid)
+        computeAccelerations();
+
+    const float half = 0.5f * dt;
+    for (size_t i = 0; i < m_mass.size(); ++i) {
+        m_vx[i] += m_acc[i].x * half; m_vy[i] += m_acc[i].y * half; m_vz[i] += m_acc[i].z * half;
+        m_x[i] += m_vx[i] * dt; m_y[i] += m_vy[i] * dt; m_z[i] += m_vz[i] * dt;
+    }
+    computeAccelerations();
+    for (size_t i = 0; i < m_mass.size(); ++i) {
+        m_vx[i] += m_acc[i].x * half; m_vy[i] += m_acc[i].y * half; m_vz[i] += m_acc[i].z * half;
+    }
+}
+
+void NBody::computeAccelerations(bool bruteForce) {
+    if (!bruteForce)
+        buildTree();
+
+    JobSystem::shared().parallelFor(m_mass.size(), kGrain, [this, bruteForce](size_t begin, size_t end) {
+        std::vector<int> stack;
+        stack.reserve(8 * kMaxDepth);
+        for (size_t k = begin; k < end; ++k) {
+            // ordre des feuilles : deux corps voisins parcourent presque le même arbre
+            const size_t i = bruteForce ? k : size_t(m_order[k]);
+            const glm::vec3 p(m_x[i], m_y[i], m_z[i]);
+            m_acc[i] = attractorAcceleration(p) + (bruteForce ? directAcceleration(i) : treeAcceleration(i, stack));
+        }
+    });
+    m_accValid = true;
+}
+
+glm::vec3 NBody::attractorAcceleration(const glm::vec3 &p) const {
+    const float eps2 = m_params.softening * m_params.softening;
+    glm::vec3 a(0.f);
+    for (size_t k = 0; k < m_attractorMass.size(); ++k) {
+        const glm::vec3 d = m_attractorPos[k] - p;
+        const float r2 = glm::dot(d, d) + eps2;
+        a += d * (m_params.G * m_attractorMass[k] / (r2 * std::sqrt(r2)));
+    }
+    return a;
+}
+
+glm::vec3 NBody::directAcceleration(size_t body) const {
+    const float eps2 = m_params.softening * m_params.softening;
+    const float px = m_x[body], py = m_y[body], pz = m_z[body];
+    float ax = 0.f, ay = 0.f, az = 0.f;
+    for (size_t j = 0; j < m_mass.size(); ++j) {
+        const float dx = m_x[j] - px, dy = m_y[j] - py, dz = m_z[j] - pz;
+        const float r2 = dx * dx + dy * dy + dz * dz + eps2;
+        // j == body : d = 0, contribution nulle, pas besoin de test
+        const float f = m_mass[j] / (r2 * std::sqrt(r2));
+        ax += dx * f; ay += dy * f; az += dz * f;
+    }
+    return m_params.G * glm::vec3(ax, ay, az);
+}
+
+glm::vec3 NBody::treeAcceleration(size_t body, std::vector<int> &stack) const {
+    const float eps2 = m_params.softening * m_params.softening;
+    const float theta2 = m_params.theta * m_params.theta;
+    const float px = m_x[body], py = m_y[body], pz = m_z[body];
+    float ax = 0.f, ay = 0.f, az = 0.f;
+
+    stack.clear();
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node &node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (node.mass == 0.f)
+            continue;
+
+        const float dx = node.comX - px, dy = node.comY - py, dz = node.comZ - pz;
+        const float d2 = dx * dx + dy * dy + dz * dz;
+        if (node.firstChild < 0) {
+            for (int k = node.begin; k < node.end; ++k) {
+                const int j = m_order[k];
+                const float ex = m_x[j] - px, ey = m_y[j] - py, ez = m_z[j] - pz;
+                const float r2 = ex * ex + ey * ey + ez * ez + eps2;
+                const float f = m_mass[j] / (r2 * std::sqrt(r2));
+                ax += ex * f; ay += ey * f; az += ez * f;
+            }
+        } else if (node.size * node.size < theta2 * d2) {
+            // assez loin : le nœud entier agit comme une masse ponctuelle
+            const float r2 = d2 + eps2;
+            const float f = node.mass / (r2 * std::sqrt(r2));
+            ax += dx * f; ay += dy * f; az += dz * f;
+        } else {
+            for (int c = 0; c < 8; ++c)
+                stack.push_back(node.firstChild + c);
+        }
+    }
+    return m_params.G * glm::vec3(ax, ay, az);
+}
+
+void NBody::buildTree() {
+    const size_t n = m_mass.size();
+    m_nodes.clear();
+    m_order.resize(n);
+    m_scratch.resize(n);
+    m_sorted.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        m_order[i] = int(i);
+    if (n == 0)
+        return;
+
+    glm::vec3 lo(m_x[0], m_y[0], m_z[0]), hi = lo;
+    for (size_t i = 1; i < n; ++i) {
+        lo = glm::min(lo, glm::vec3(m_x[i], m_y[i], m_z[i]));
+        hi = glm::max(hi, glm::vec3(m_x[i], m_y[i], m_z[i]));
+    }
+    const glm::vec3 extent = hi - lo;
+    const float half = 0.5f * std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) * 1.001f;
+
+    m_nodes.reserve(2 * n / kLeafSize + 16);
+    m_nodes.push_back(Node());
+    buildNode(0, 0, int(n), 0.5f * (lo + hi), half, 0);
+}
+
+// Remplit m_nodes[index] pour les corps m_order[begin, end).
+void NBody::buildNode(int index, int begin, int end, const glm::vec3 &center, float half, int depth) {
+    Node node;
+    node.size = 2.f * half;
+    node.firstChild = -1;
+    node.begin = begin;
+    node.end = end;
+
+    float m = 0.f, cx = 0.f, cy = 0.f, cz = 0.f;
+    if (end - begin <= kLeafSize || depth >= kMaxDepth) {
+        for (int k = begin; k < end; ++k) {
+            const int j = m_order[k];
+            m += m_mass[j];
+            cx += m_mass[j] * m_x[j]; cy += m_mass[j] * m_y[j]; cz += m_mass[j] * m_z[j];
+        }
+    } else {
+        // tri par dénombrement des corps dans les 8 octants
+        int start[9] = { 0 };
+        for (int k = begin; k < end; ++k) {
+            const int j = m_order[k];
+            const int octant = (m_x[j] >= center.x ? 1 : 0) | (m_y[j] >= center.y ? 2 : 0) | (m_z[j] >= center.z ? 4 : 0);
+            m_scratch[k] = octant;
+            ++start[octant + 1];
+        }
+        start[0] = begin;
+        for (int c = 0; c < 8; ++c)
+            start[c + 1] += start[c];
+        int fill[8];
+        std::copy(start, start + 8, fill);
+        for (int k = begin; k < end; ++k)
+            m_sorted[fill[m_scratch[k]]++] = m_order[k];
+        std::copy(m_sorted.begin() + begin, m_sorted.begin() + end, m_order.begin() + begin);
+
+        // les 8 enfants sont contigus, leurs sous-arbres suivent en profondeur
+        node.firstChild = int(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + 8);
+        for (int c = 0; c < 8; ++c) {
+            const glm::vec3 offset((c & 1) ? half : -half, (c & 2) ? half : -half, (c & 4) ? half : -half);
+            buildNode(node.firstChild + c, start[c], start[c + 1], center + 0.5f * offset, 0.5f * half, depth + 1);
+            const Node &child = m_nodes[node.firstChild + c];
+            m += child.mass;
+            cx += child.mass * child.comX; cy += child.mass * child.comY; cz += child.mass * child.comZ;
+        }
+    }
+
+    node.mass = m;
+    node.comX = m > 0.f ? cx / m : center.x;
+    node.comY = m > 0.f ? cy / m : center.y;
+    node.comZ = m > 0.f ? cz / m : center.z;
+    m_nodes[index] = node;
+}
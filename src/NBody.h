@@ -0,0 +1,72 @@
+#ifndef NBODY_H
+#define NBODY_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Intégrateur gravitationnel pour des milliers à des millions de petits
+// corps (astéroïdes, débris). Les forces mutuelles sont approchées par
+// Barnes-Hut : un octree reconstruit à chaque pas dans un tableau plat,
+// parcouru en profondeur. Les corps massifs du système (Soleil, planètes)
+// sont des attracteurs exacts, imposés de l'extérieur à chaque pas.
+class NBody
+{
+public:
+    struct Params {
+        float theta = 0.5f;       // angle d'ouverture : 0 = somme exacte
+        float softening = 0.05f;  // adoucissement de Plummer
+        float G = 1.f;
+    };
+
+    NBody();
+
+    Params &params() { return m_params; }
+
+    int add(const glm::vec3 &position, const glm::vec3 &velocity, float mass);
+    size_t size() const { return m_mass.size(); }
+    glm::vec3 position(size_t i) const { return glm::vec3(m_x[i], m_y[i], m_z[i]); }
+    glm::vec3 velocity(size_t i) const { return glm::vec3(m_vx[i], m_vy[i], m_vz[i]); }
+    const glm::vec3 &acceleration(size_t i) const { return m_acc[i]; }
+
+    // Remplace les attracteurs (positions monde et masses).
+    void setAttractors(const std::vector<glm::vec3> &positions, const std::vector<float> &masses);
+
+    // Un pas de saute-mouton (kick-drift-kick) de durée dt.
+    void step(float dt);
+
+    // Accélérations de tous les corps : Barnes-Hut ou somme directe O(N^2).
+    void computeAccelerations(bool bruteForce = false);
+
+    size_t nodeCount() const { return m_nodes.size(); }
+
+private:
+    struct Node {
+        float comX, comY, comZ, mass;  // centre de masse et masse totale
+        float size;                    // arête du cube
+        int firstChild;                // 8 enfants consécutifs, -1 pour une feuille
+        int begin, end;                // plage dans m_order (feuilles)
+    };
+
+    void buildTree();
+    void buildNode(int index, int begin, int end, const glm::vec3 &center, float half, int depth);
+    glm::vec3 treeAcceleration(size_t body, std::vector<int> &stack) const;
+    glm::vec3 directAcceleration(size_t body) const;
+    glm::vec3 attractorAcceleration(const glm::vec3 &p) const;
+
+    Params m_params;
+    std::vector<float> m_x, m_y, m_z;
+    std::vector<float> m_vx, m_vy, m_vz;
+    std::vector<float> m_mass;
+    std::vector<glm::vec3> m_acc;
+    bool m_accValid = false;
+
+    std::vector<glm::vec3> m_attractorPos;
+    std::vector<float> m_attractorMass;
+
+    std::vector<Node> m_nodes;
+    std::vector<int> m_order;     // indices des corps, dans l'ordre des feuilles
+    std::vector<int> m_scratch;   // octant de chaque corps pendant la construction
+    std::vector<int> m_sorted;
+};
+
+#endif // NBODY_H
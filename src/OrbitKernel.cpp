@@ -0,0 +1,72 @@
+#include "OrbitKernel.h"
+#include "Kepler.h"
+#include "SimdMath.h"
+
+#include <cmath>
+
+// Un corps, en scalaire : sert pour la fin du tableau et sans SIMD.
+static inline void computeOne(size_t i, double t, const OrbitBatch &in, glm::mat4 *model) {
+    const float g = wrapAngle(t * double(in.spinRate[i]));
+    const float cg = std::cos(g), sg = std::sin(g);
+    const float cb = in.cosTilt[i], sb = in.sinTilt[i];
+    const float s = in.size[i];
+
+    glm::mat4 &m = model[i];
+    m[0] = glm::vec4(s * cg, s * sb * sg, -s * cb * sg, 0.f);
+    m[1] = glm::vec4(0.f, s * cb, s * sb, 0.f);
+    m[2] = glm::vec4(s * sg, -s * sb * cg, s * cb * cg, 0.f);
+    m[3] = glm::vec4(in.posX[i], in.posY[i], in.posZ[i], 1.f);
+}
+
+#ifdef SIMD_WIDTH
+
+static inline void computeLanes(size_t i, double t, const OrbitBatch &in, glm::mat4 *model) {
+    // t * spinRate grandit sans borne : réduit en double, vsincos reçoit [-pi, pi]
+    alignas(32) float spin[SIMD_WIDTH];
+    for (size_t l = 0; l < SIMD_WIDTH; ++l)
+        spin[l] = wrapAngle(t * double(in.spinRate[i + l]));
+    vfloat cg, sg;
+    vsincos(vload(spin), sg, cg);
+    const vfloat cb = vload(in.cosTilt + i), sb = vload(in.sinTilt + i);
+    const vfloat s = vload(in.size + i);
+
+    // coefficients de Rx(b) Ry(g), colonne par colonne, déjà mis à l'échelle
+    const vfloat ssb = vmul(s, sb), scb = vmul(s, cb);
+    alignas(32) float lane[8][SIMD_WIDTH];
+    vstore(lane[0], vmul(s, cg));           // m[0].x
+    vstore(lane[1], vmul(ssb, sg));         // m[0].y
+    vstore(lane[2], vneg(vmul(scb, sg)));   // m[0].z
+    vstore(lane[3], scb);                   // m[1].y
+    vstore(lane[4], ssb);                   // m[1].z
+    vstore(lane[5], vmul(s, sg));           // m[2].x
+    vstore(lane[6], vneg(vmul(ssb, cg)));   // m[2].y
+    vstore(lane[7], vmul(scb, cg));         // m[2].z
+
+    for (size_t l = 0; l < SIMD_WIDTH; ++l) {
+        glm::mat4 &m = model[i + l];
+        m[0] = glm::vec4(lane[0][l], lane[1][l], lane[2][l], 0.f);
+        m[1] = glm::vec4(0.f, lane[3][l], lane[4][l], 0.f);
+        m[2] = glm::vec4(lane[5][l], lane[6][l], lane[7][l], 0.f);
+        m[3] = glm::vec4(in.posX[i + l], in.posY[i + l], in.posZ[i + l], 1.f);
+    }
+}
+
+#endif // SIMD_WIDTH
+
+void computeOrbitalModels(size_t n, double t, const OrbitBatch &in, glm::mat4 *model) {
+    size_t i = 0;
+#ifdef SIMD_WIDTH
+    for (; i + SIMD_WIDTH <= n; i += SIMD_WIDTH)
+        computeLanes(i, t, in, model);
+#endif
+    for (; i < n; ++i)
+        computeOne(i, t, in, model);
+}
+
+size_t orbitKernelWidth() {
+#ifdef SIMD_WIDTH
+    return SIMD_WIDTH;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,28 @@
+#ifndef ORBITKERNEL_H
+#define ORBITKERNEL_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Entrées du noyau, une valeur par corps (tableaux contigus de taille n).
+// Les inclinaisons sont fixes : on ne passe que leurs cos/sin précalculés.
+struct OrbitBatch {
+    const float *posX;      // position monde, déjà propagée (Kepler)
+    const float *posY;
+    const float *posZ;
+    const float *cosTilt;
+    const float *sinTilt;
+    const float *spinRate;
+    const float *size;
+};
+
+// Calcule au temps t, pour n corps, la matrice modèle
+//     T(position) * Rx(inclinaison) * Ry(rotation propre) * S(taille)
+// sous forme fermée, plusieurs corps à la fois (AVX2 : 8, SSE2 : 4).
+// L'angle de rotation propre est réduit en double avant les sinus.
+void computeOrbitalModels(size_t n, double t, const OrbitBatch &in, glm::mat4 *model);
+
+// Largeur SIMD utilisée par computeOrbitalModels (1 sans SIMD).
+size_t orbitKernelWidth();
+
+#endif // ORBITKERNEL_H
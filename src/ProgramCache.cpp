@@ -0,0 +1,150 @@
+#include "ProgramCache.h"
+#include "MappedFile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+static const char kMagic[4] = { 'S', 'P', 'R', 'G' };
+static const uint32_t kVersion = 1;
+
+struct ProgramHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;            // vérifiée en plus du nom de fichier
+    uint32_t binaryFormat;
+    uint32_t binaryLength;   // octets du binaire qui suit l'en-tête
+    double buildSeconds;
+};
+
+// FNV-1a 64 bits, chaque morceau suivi d'un séparateur
+static uint64_t hashBytes(uint64_t h, const char *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ull;
+    }
+    h ^= 0xffu;
+    h *= 1099511628211ull;
+    return h;
+}
+
+static uint64_t hashGLString(uint64_t h, GLenum name) {
+    const char *s = reinterpret_cast<const char *>(glGetString(name));
+    return s ? hashBytes(h, s, std::strlen(s)) : hashBytes(h, "", 0);
+}
+
+ProgramCache::ProgramCache(const std::string &directory) : m_directory(directory) {
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+    GLint formats = 0;
+    if (GLAD_GL_ARB_get_program_binary && glGetProgramBinary && glProgramBinary)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    m_available = formats > 0;
+
+    uint64_t h = 1469598103934665603ull;
+    h = hashGLString(h, GL_VENDOR);
+    h = hashGLString(h, GL_RENDERER);
+    h = hashGLString(h, GL_VERSION);
+    m_driverHash = h;
+}
+
+uint64_t ProgramCache::key(const std::vector<std::string> &sources, const std::vector<std::string> &defines) const {
+    uint64_t h = m_driverHash;
+    for (size_t i = 0; i < sources.size(); ++i)
+        h = hashBytes(h, sources[i].data(), sources[i].size());
+    h = hashBytes(h, "", 0);  // sépare les sources des #define
+    for (size_t i = 0; i < defines.size(); ++i)
+        h = hashBytes(h, defines[i].data(), defines[i].size());
+    return h;
+}
+
+std::string ProgramCache::entryPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.spb", (unsigned long long)key);
+    return m_directory + "/" + name;
+}
+
+void ProgramCache::prepare(GLuint program) const {
+    if (m_available)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool ProgramCache::load(uint64_t key, GLuint program) {
+    ++m_misses;  // annulé en cas de succès
+    MappedFile file;
+    if (!m_available || !file.open(entryPath(key)))
+        return false;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ProgramHeader header;
+    if (file.size() < sizeof(header))
+        return false;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion || header.key != key
+        || sizeof(header) + header.binaryLength > file.size())
+        return false;
+
+    // le pilote peut refuser un binaire pourtant bien formé (mise à jour, autre GPU...)
+    glProgramBinary(program, GLenum(header.binaryFormat), file.data() + sizeof(header), GLsizei(header.binaryLength));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+        return false;
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (header.buildSeconds > seconds)
+        m_secondsSaved += header.buildSeconds - seconds;
+    --m_misses;
+    ++m_hits;
+    return true;
+}
+
+bool ProgramCache::store(uint64_t key, GLuint program, double buildSeconds) {
+    GLint linked = GL_FALSE, length = 0;
+    if (!m_available)
+        return false;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (!linked || length <= 0)
+        return false;
+
+    std::vector<unsigned char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return false;
+
+    ProgramHeader header;
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.key = key;
+    header.binaryFormat = uint32_t(format);
+    header.binaryLength = uint32_t(written);
+    header.buildSeconds = buildSeconds;
+
+    // écriture dans un fichier temporaire puis renommage : jamais d'entrée à moitié écrite
+    const std::string path = entryPath(key), temp = path + ".tmp";
+    {
+        std::ofstream file(temp.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "WARNING: cannot write program cache entry " << temp << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(binary.data()), std::streamsize(written));
+        if (!file)
+            return false;
+    }
+    std::remove(path.c_str());  // rename n'écrase pas sous Windows
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,49 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glad/gl.h>
+
+// Programmes GPU déjà liés, conservés sur disque (GL_ARB_get_program_binary,
+// cœur depuis GL 4.1) : un fichier par programme, nommé par une clé qui
+// couvre les sources, les #define et le pilote (vendeur, renderer,
+// version). Un binaire est propre à un pilote : tout changement de l'un de
+// ces éléments donne une autre clé. Fichier absent, illisible ou refusé par
+// le pilote : l'appelant compile et lie normalement, puis appelle store().
+class ProgramCache
+{
+public:
+    // Thread GL, contexte courant. Crée le dossier au besoin.
+    explicit ProgramCache(const std::string &directory);
+
+    // Faux sans l'extension, ou si le pilote n'expose aucun format binaire :
+    // load() échoue alors toujours et store() ne fait rien.
+    bool available() const { return m_available; }
+
+    uint64_t key(const std::vector<std::string> &sources, const std::vector<std::string> &defines) const;
+
+    // À appeler avant glLinkProgram pour que le binaire soit récupérable.
+    void prepare(GLuint program) const;
+    // Charge l'entrée dans program (créé, sans shader attaché) ; true s'il est lié.
+    bool load(uint64_t key, GLuint program);
+    // buildSeconds : temps de compilation et de lien, pour estimer le gain des prochains chargements.
+    bool store(uint64_t key, GLuint program, double buildSeconds);
+
+    unsigned hits() const { return m_hits; }
+    unsigned misses() const { return m_misses; }
+    // Somme, sur les succès, du temps de construction enregistré moins le temps de chargement.
+    double secondsSaved() const { return m_secondsSaved; }
+
+private:
+    std::string entryPath(uint64_t key) const;
+
+    std::string m_directory;
+    bool m_available = false;
+    uint64_t m_driverHash = 0;
+    unsigned m_hits = 0, m_misses = 0;
+    double m_secondsSaved = 0.0;
+};
+
+#endif // PROGRAMCACHE_H
@@ -0,0 +1,36 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+int SceneGraph::add(int parent, const glm::mat4 &local) {
+    assert(parent < int(m_parent.size()));
+    m_parent.push_back(parent);
+    m_local.push_back(local);
+    m_world.push_back(local);
+    m_dirty.push_back(1);
+    return int(m_parent.size()) - 1;
+}
+
+void SceneGraph::setLocal(int node, const glm::mat4 &local) {
+    if (std::memcmp(&m_local[node], &local, sizeof(glm::mat4)) == 0)
+        return;
+    m_local[node] = local;
+    m_dirty[node] = 1;
+}
+
+void SceneGraph::update() {
+    m_updated = 0;
+    for (size_t i = 0; i < m_parent.size(); ++i) {
+        const int parent = m_parent[i];
+        // le parent, déjà traité, garde son drapeau jusqu'à la fin du parcours
+        if (parent >= 0 && m_dirty[parent])
+            m_dirty[i] = 1;
+        if (!m_dirty[i])
+            continue;
+        m_world[i] = parent >= 0 ? m_world[parent] * m_local[i] : m_local[i];
+        ++m_updated;
+    }
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+}
@@ -0,0 +1,38 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Hiérarchie de repères dans un tableau plat trié topologiquement : un
+// parent a toujours un indice inférieur à ses enfants, un seul parcours
+// croissant suffit donc à propager world = world(parent) * local.
+// Un nœud n'est recalculé que si sa matrice locale ou celle d'un ancêtre
+// a changé depuis le dernier update() : les sous-arbres immobiles ne
+// coûtent qu'un test.
+class SceneGraph
+{
+public:
+    // parent = -1 pour une racine ; sinon parent < indice du nouveau nœud.
+    int add(int parent, const glm::mat4 &local = glm::mat4(1.0f));
+
+    // Ne marque le nœud modifié que si la matrice diffère réellement.
+    void setLocal(int node, const glm::mat4 &local);
+
+    void update();
+
+    size_t size() const { return m_parent.size(); }
+    int parent(size_t node) const { return m_parent[node]; }
+    const glm::mat4 &local(size_t node) const { return m_local[node]; }
+    const glm::mat4 &world(size_t node) const { return m_world[node]; }
+    size_t updatedLastPass() const { return m_updated; }  // nœuds recalculés
+
+private:
+    std::vector<int> m_parent;
+    std::vector<glm::mat4> m_local;
+    std::vector<glm::mat4> m_world;
+    std::vector<unsigned char> m_dirty;  // local modifiée, puis « monde recalculé » pendant update()
+    size_t m_updated = 0;
+};
+
+#endif // SCENEGRAPH_H
@@ -0,0 +1,165 @@
+#include "ShaderPipeline.h"
+#include "ProgramCache.h"
+#include "ShaderVariants.h"
+#include "Timeline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+ShaderPipeline::ShaderPipeline(ProgramCache *cache, const Timeline *timeline,
+                               const std::vector<std::string> &vertexDefines)
+    : m_cache(cache), m_timeline(timeline), m_vertexDefines(vertexDefines) {
+    m_parallel = GLAD_GL_KHR_parallel_shader_compile && glMaxShaderCompilerThreadsKHR;
+    if (m_parallel)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);  // autant de threads que le pilote le juge utile
+}
+
+ShaderPipeline::~ShaderPipeline() {
+    for (std::map<std::string, GLuint>::iterator it = m_shaders.begin(); it != m_shaders.end(); ++it)
+        glDeleteShader(it->second);
+}
+
+double ShaderPipeline::nowMs() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ShaderPipeline::mark(const std::string &stage) const {
+    if (m_timeline)
+        m_timeline->mark(stage);
+}
+
+GLuint ShaderPipeline::shader(GLenum type, const std::string &file, const std::vector<std::string> &defines) {
+    std::string name = file;
+    for (size_t i = 0; i < defines.size(); ++i)
+        name += '|' + defines[i];
+    std::map<std::string, GLuint>::iterator it = m_shaders.find(name);
+    if (it != m_shaders.end())
+        return it->second;
+
+    const EmbeddedShader *embedded = findEmbeddedShader(file);
+    if (!embedded) {
+        std::cout << "ERROR: shader " << file << " is not embedded in the binary" << std::endl;
+        return 0;
+    }
+    const std::string source = injectDefines(*embedded, defines);
+    const GLchar *text = source.c_str();
+    const GLuint id = glCreateShader(type);
+    glShaderSource(id, 1, &text, NULL);
+    glCompileShader(id);  // statut lu seulement si le lien échoue
+    m_shaders[name] = id;
+    return id;
+}
+
+GLuint ShaderPipeline::submit(const std::string &label, const std::string &vertexFile,
+                              const std::string &fragmentFile, const std::vector<std::string> &defines) {
+    const double start = nowMs();
+    Pending pending;
+    pending.label = label;
+    pending.key = 0;
+    pending.program = glCreateProgram();
+
+    if (m_cache) {
+        const EmbeddedShader *vertex = findEmbeddedShader(vertexFile);
+        const EmbeddedShader *fragment = findEmbeddedShader(fragmentFile);
+        std::vector<std::string> sources;
+        if (vertex && fragment) {
+            sources.push_back(std::string(reinterpret_cast<const char *>(vertex->source), vertex->length));
+            sources.push_back(std::string(reinterpret_cast<const char *>(fragment->source), fragment->length));
+        }
+        // un élément vide sépare les #define du vertex shader de ceux du fragment shader
+        std::vector<std::string> allDefines(m_vertexDefines);
+        allDefines.push_back(std::string());
+        allDefines.insert(allDefines.end(), defines.begin(), defines.end());
+        pending.key = m_cache->key(sources, allDefines);
+        // un binaire se charge en une fraction du temps d'une compilation : pas d'attente à différer
+        if (m_cache->load(pending.key, pending.program)) {
+            mark("Program " + label + ": loaded from the program cache");
+            return pending.program;
+        }
+    }
+
+    pending.shaders.push_back(shader(GL_VERTEX_SHADER, vertexFile, m_vertexDefines));
+    pending.shaders.push_back(shader(GL_FRAGMENT_SHADER, fragmentFile, defines));
+    for (size_t i = 0; i < pending.shaders.size(); ++i)
+        glAttachShader(pending.program, pending.shaders[i]);
+    if (m_cache)
+        m_cache->prepare(pending.program);
+    glLinkProgram(pending.program);
+    pending.submittedAt = nowMs();
+    pending.submitMs = pending.submittedAt - start;
+    m_pending.push_back(pending);
+    mark("Program " + label + ": compile and link submitted");
+    return pending.program;
+}
+
+bool ShaderPipeline::finish(GLuint program) {
+    size_t index = 0;
+    while (index < m_pending.size() && m_pending[index].program != program)
+        ++index;
+    if (index == m_pending.size())
+        return true;
+    const Pending &pending = m_pending[index];
+
+    // sans bloquer : le pilote a-t-il déjà fini en arrière-plan ?
+    GLint completed = GL_FALSE;
+    if (m_parallel)
+        glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+    const double start = nowMs();
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);  // attend la fin du lien
+    const double waited = nowMs() - start;
+    m_waitedMs += waited;
+
+    if (!linked) {
+        GLchar infoLog[512];
+        for (size_t i = 0; i < pending.shaders.size(); ++i) {
+            GLint compiled = GL_FALSE;
+            glGetShaderiv(pending.shaders[i], GL_COMPILE_STATUS, &compiled);
+            if (!compiled) {
+                glGetShaderInfoLog(pending.shaders[i], 512, NULL, infoLog);
+                std::cout << "ERROR in compiling " << pending.label << "\n\t" << infoLog << std::endl;
+            }
+        }
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        std::cout << "ERROR in linking " << pending.label << "\n\t" << infoLog << std::endl;
+    } else if (m_cache) {
+        // ce que coûterait ce programme sans le cache : soumission et attente sur le thread GL
+        m_cache->store(pending.key, program, (pending.submitMs + waited) * 1e-3);
+    }
+
+    char stage[160];
+    std::snprintf(stage, sizeof(stage), "ready %.1f ms after submission, %s %.1f ms",
+                  start - pending.submittedAt, completed ? "already complete, query" : "waited", waited);
+    mark("Program " + pending.label + ": " + (linked ? stage : "failed"));
+    release(index);
+    return linked == GL_TRUE;
+}
+
+void ShaderPipeline::cancel(GLuint program) {
+    for (size_t i = 0; i < m_pending.size(); ++i) {
+        if (m_pending[i].program == program) {
+            release(i);
+            break;
+        }
+    }
+    glDeleteProgram(program);
+}
+
+void ShaderPipeline::release(size_t index) {
+    m_pending.erase(m_pending.begin() + long(index));
+    // un shader reste tant qu'un programme en attente peut encore devoir afficher son journal
+    std::map<std::string, GLuint>::iterator it = m_shaders.begin();
+    while (it != m_shaders.end()) {
+        bool used = false;
+        for (size_t i = 0; i < m_pending.size() && !used; ++i)
+            for (size_t s = 0; s < m_pending[i].shaders.size() && !used; ++s)
+                used = m_pending[i].shaders[s] == it->second;
+        if (used) {
+            ++it;
+        } else {
+            glDeleteShader(it->second);  // détaché à la destruction des programmes
+            m_shaders.erase(it++);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SHADERPIPELINE_H
+#define SHADERPIPELINE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <glad/gl.h>
+
+class ProgramCache;
+class Timeline;
+
+// Construction des programmes sans attente : submit() envoie compilations
+// et lien au pilote (ou charge le binaire du ProgramCache) et rend la main
+// sans lire aucun statut, ce qui forcerait le pilote à terminer. Avec
+// GL_KHR_parallel_shader_compile, il les traite sur ses propres threads
+// pendant que le démarrage continue (textures, maillages). Le statut n'est
+// lu que par finish(), au premier besoin du programme.
+class ShaderPipeline
+{
+public:
+    // Thread GL. cache et timeline peuvent être nuls. vertexDefines : #define
+    // communs à tous les vertex shaders (constantes venues du C++).
+    ShaderPipeline(ProgramCache *cache, const Timeline *timeline,
+                   const std::vector<std::string> &vertexDefines = std::vector<std::string>());
+    ~ShaderPipeline();
+
+    bool parallel() const { return m_parallel; }
+
+    // Shaders intégrés au binaire (ShaderVariants.h) ; defines ne
+    // s'appliquent qu'au fragment shader. label sert aux messages.
+    GLuint submit(const std::string &label, const std::string &vertexFile,
+                  const std::string &fragmentFile, const std::vector<std::string> &defines);
+    // Attend au besoin la fin du lien, affiche les erreurs et enregistre le
+    // binaire dans le cache. Sans effet sur un programme déjà terminé.
+    bool finish(GLuint program);
+    // Abandonne un programme soumis qui ne servira pas, et le détruit.
+    void cancel(GLuint program);
+
+    size_t pending() const { return m_pending.size(); }
+    // Temps passé bloqué dans finish(), depuis la création.
+    double waitedMs() const { return m_waitedMs; }
+
+private:
+    struct Pending {
+        GLuint program;
+        std::string label;
+        uint64_t key;
+        std::vector<GLuint> shaders;
+        double submitMs;     // temps passé dans submit()
+        double submittedAt;  // instant de la soumission (chronomètre interne)
+    };
+
+    GLuint shader(GLenum type, const std::string &file, const std::vector<std::string> &defines);
+    void mark(const std::string &stage) const;
+    double nowMs() const;
+    void release(size_t index);
+
+    ProgramCache *m_cache;
+    const Timeline *m_timeline;
+    std::vector<std::string> m_vertexDefines;
+    bool m_parallel = false;
+    std::vector<Pending> m_pending;
+    // Shaders compilés, par fichier et #define : partagés entre programmes,
+    // détruits quand plus aucun programme en attente ne les utilise.
+    std::map<std::string, GLuint> m_shaders;
+    double m_waitedMs = 0.0;
+};
+
+#endif // SHADERPIPELINE_H
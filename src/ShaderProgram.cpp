@@ -0,0 +1,93 @@
+#include "ShaderProgram.h"
+
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+std::shared_ptr<ShaderProgram> ShaderProgram::wrap(GLuint program) {
+    auto shader = std::make_shared<ShaderProgram>();
+    shader->m_program = program;
+    shader->reflect();
+    return shader;
+}
+
+void ShaderProgram::reflect() {
+    m_uniforms.clear();
+    m_names.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> name(maxLength > 0 ? maxLength : 1);
+
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_program, GLuint(i), GLsizei(name.size()), &length, &size, &type, name.data());
+        std::string uniformName(name.data(), length);
+
+        Slot slot;
+        slot.location = glGetUniformLocation(m_program, uniformName.c_str());
+        slot.type = type;
+        if (slot.location < 0)
+            continue; // membre d'un uniform block, pas de location propre
+
+        const Uniform handle = Uniform(m_uniforms.size());
+        m_uniforms.push_back(slot);
+        m_names[uniformName] = handle;
+
+        // Les tableaux sont rapportés comme "nom[0]" : on accepte aussi "nom".
+        const size_t bracket = uniformName.rfind("[0]");
+        if (bracket != std::string::npos && bracket + 3 == uniformName.size())
+            m_names[uniformName.substr(0, bracket)] = handle;
+    }
+}
+
+ShaderProgram::Uniform ShaderProgram::uniform(const std::string &name) const {
+    std::map<std::string, Uniform>::const_iterator it = m_names.find(name);
+    return it == m_names.end() ? kInvalid : it->second;
+}
+
+bool ShaderProgram::changed(Uniform u, const void *data, size_t bytes) {
+    Slot &slot = m_uniforms[u];
+    if (slot.valid && std::memcmp(slot.shadow, data, bytes) == 0) {
+        ++m_skipped;
+        return false;
+    }
+    std::memcpy(slot.shadow, data, bytes);
+    slot.valid = true;
+    ++m_uploads;
+    return true;
+}
+
+// Les set() supposent que le programme est actif (use()).
+void ShaderProgram::set(Uniform u, int v) {
+    if (u < 0 || !changed(u, &v, sizeof(v)))
+        return;
+    glUniform1i(m_uniforms[u].location, v);
+}
+
+void ShaderProgram::set(Uniform u, float v) {
+    if (u < 0 || !changed(u, &v, sizeof(v)))
+        return;
+    glUniform1f(m_uniforms[u].location, v);
+}
+
+void ShaderProgram::set(Uniform u, const glm::vec3 &v) {
+    if (u < 0 || !changed(u, glm::value_ptr(v), sizeof(v)))
+        return;
+    glUniform3fv(m_uniforms[u].location, 1, glm::value_ptr(v));
+}
+
+void ShaderProgram::set(Uniform u, const glm::mat4 &v) {
+    if (u < 0 || !changed(u, glm::value_ptr(v), sizeof(v)))
+        return;
+    glUniformMatrix4fv(m_uniforms[u].location, 1, GL_FALSE, glm::value_ptr(v));
+}
+
+void ShaderProgram::endFrame() {
+    m_uploadsLastFrame = m_uploads;
+    m_skippedLastFrame = m_skipped;
+    m_uploads = 0;
+    m_skipped = 0;
+}
@@ -0,0 +1,59 @@
+#ifndef SHADERPROGRAM_H
+#define SHADERPROGRAM_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+
+// Enveloppe d'un programme GPU déjà lié : les uniforms actifs sont
+// réfléchis une seule fois, puis adressés par des handles pré-résolus.
+// Chaque set() compare la valeur à une copie locale et n'appelle
+// glUniform* que si elle a changé.
+class ShaderProgram {
+public:
+    typedef int Uniform; // indice dans m_uniforms, -1 si inactif
+    static const Uniform kInvalid = -1;
+
+    static std::shared_ptr<ShaderProgram> wrap(GLuint program);
+
+    void use() const { glUseProgram(m_program); }
+    GLuint id() const { return m_program; }
+
+    Uniform uniform(const std::string &name) const;
+
+    void set(Uniform u, int v);
+    void set(Uniform u, float v);
+    void set(Uniform u, const glm::vec3 &v);
+    void set(Uniform u, const glm::mat4 &v);
+
+    // Compteurs par frame : endFrame() fige ceux de la frame écoulée.
+    void endFrame();
+    size_t uploadsLastFrame() const { return m_uploadsLastFrame; }
+    size_t skippedLastFrame() const { return m_skippedLastFrame; }
+
+private:
+    struct Slot {
+        GLint location = -1;
+        GLenum type = 0;
+        bool valid = false;          // la copie locale reflète-t-elle le GPU ?
+        float shadow[16] = {};
+    };
+
+    void reflect();
+    bool changed(Uniform u, const void *data, size_t bytes);
+
+    GLuint m_program = 0;
+    std::vector<Slot> m_uniforms;
+    std::map<std::string, Uniform> m_names;
+
+    size_t m_uploads = 0;
+    size_t m_skipped = 0;
+    size_t m_uploadsLastFrame = 0;
+    size_t m_skippedLastFrame = 0;
+};
+
+#endif // SHADERPROGRAM_H
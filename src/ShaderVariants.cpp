@@ -0,0 +1,63 @@
+#include "ShaderVariants.h"
+
+#include <algorithm>
+#include <cstring>
+
+const EmbeddedShader *findEmbeddedShader(const std::string &name) {
+    for (size_t i = 0; i < kEmbeddedShaderCount; ++i)
+        if (name == kEmbeddedShaders[i].name)
+            return &kEmbeddedShaders[i];
+    return nullptr;
+}
+
+static const struct {
+    unsigned feature;
+    const char *define;
+} kFeatureDefines[] = {
+    { kShaderEmissive, "EMISSIVE" },
+    { kShaderLit, "LIT" },
+    { kShaderTextured, "TEXTURED" },
+    { kShaderVirtual, "VIRTUAL_TEXTURE" },
+};
+
+std::string ShaderVariant::name() const {
+    std::string out;
+    for (size_t i = 0; i < sizeof(kFeatureDefines) / sizeof(kFeatureDefines[0]); ++i) {
+        if (!(features & kFeatureDefines[i].feature))
+            continue;
+        if (!out.empty())
+            out += '+';
+        out += kFeatureDefines[i].define;
+    }
+    return (out.empty() ? std::string("UNLIT") : out) + " q" + std::to_string(quality);
+}
+
+std::vector<std::string> shaderDefines(const ShaderVariant &variant) {
+    std::vector<std::string> defines;
+    for (size_t i = 0; i < sizeof(kFeatureDefines) / sizeof(kFeatureDefines[0]); ++i)
+        if (variant.features & kFeatureDefines[i].feature)
+            defines.push_back(std::string("#define ") + kFeatureDefines[i].define);
+    defines.push_back("#define QUALITY " + std::to_string(variant.quality));
+    return defines;
+}
+
+std::string injectDefines(const EmbeddedShader &shader, const std::vector<std::string> &defines) {
+    const char *begin = reinterpret_cast<const char *>(shader.source);
+    const char *end = begin + shader.length;
+    // #version doit rester la première instruction : on insère après sa ligne
+    const char *version = std::strstr(begin, "#version");
+    const char *insert = begin;
+    if (version && version < end) {
+        const char *eol = static_cast<const char *>(std::memchr(version, '\n', size_t(end - version)));
+        insert = eol ? eol + 1 : end;
+    }
+    std::string out(begin, insert);
+    if (insert == end && insert > begin && insert[-1] != '\n')
+        out += '\n';
+    for (size_t i = 0; i < defines.size(); ++i)
+        out += defines[i] + '\n';
+    // les numéros de ligne des erreurs restent ceux du fichier
+    out += "#line " + std::to_string(std::count(begin, insert, '\n') + 1) + '\n';
+    out.append(insert, end);
+    return out;
+}
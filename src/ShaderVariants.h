@@ -0,0 +1,49 @@
+#ifndef SHADERVARIANTS_H
+#define SHADERVARIANTS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Sources GLSL copiées dans le binaire à la compilation (embedShaders.cmake,
+// fichier EmbeddedShaders.cpp généré) : aucun fichier lu au démarrage.
+struct EmbeddedShader {
+    const char *name;             // fichier d'origine, ex. "fragmentShader.glsl"
+    const unsigned char *source;  // suivi d'un zéro, non compté dans length
+    size_t length;
+};
+extern const EmbeddedShader kEmbeddedShaders[];
+extern const size_t kEmbeddedShaderCount;
+
+// nullptr si aucun shader de ce nom n'a été intégré.
+const EmbeddedShader *findEmbeddedShader(const std::string &name);
+
+// Permutations du fragment shader des corps : chaque combinaison est
+// compilée à part avec ses #define, le shader n'a plus de branchement
+// dynamique sur le type de corps.
+enum ShaderFeature : unsigned {
+    kShaderEmissive = 1u << 0,  // EMISSIVE : couleur propre, sans éclairage
+    kShaderLit = 1u << 1,       // LIT : ambiant, diffus et spéculaire du Soleil
+    kShaderTextured = 1u << 2,  // TEXTURED : albédo lu dans le tableau de textures
+    kShaderVirtual = 1u << 3,   // VIRTUAL_TEXTURE : albédo lu dans la texture virtuelle
+};
+
+struct ShaderVariant {
+    unsigned features;
+    int quality;  // QUALITY, 0 : sans spéculaire
+
+    explicit ShaderVariant(unsigned features = 0, int quality = 1) : features(features), quality(quality) {}
+
+    bool operator==(const ShaderVariant &other) const {
+        return features == other.features && quality == other.quality;
+    }
+    // Pour les messages, ex. "LIT+TEXTURED q1".
+    std::string name() const;
+};
+
+// Lignes "#define ..." de la variante, dans un ordre fixe.
+std::vector<std::string> shaderDefines(const ShaderVariant &variant);
+// Source à compiler : les #define insérés juste après la ligne #version.
+std::string injectDefines(const EmbeddedShader &shader, const std::vector<std::string> &defines);
+
+#endif // SHADERVARIANTS_H
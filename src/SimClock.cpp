@@ -0,0 +1,47 @@
+#include "SimClock.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+SimClock::SimClock(double step, int maxStepsPerFrame)
+    : m_step(step), m_maxSteps(maxStepsPerFrame) {}
+
+int SimClock::advance(double realSeconds) {
+    if (m_paused || realSeconds <= 0.0)
+        return 0;
+
+    m_accumulator += realSeconds * m_warp;
+    int steps = int(m_accumulator / m_step);
+    if (steps > m_maxSteps) {
+        // simulation trop lente pour ce facteur : on abandonne le retard
+        steps = m_maxSteps;
+        m_accumulator = m_step * steps;
+    }
+    m_accumulator -= m_step * steps;
+    m_time += m_step * steps;
+    return steps;
+}
+
+static glm::mat4 interpolateModel(const glm::mat4 &a, const glm::mat4 &b, float alpha) {
+    const glm::vec3 sa(glm::length(glm::vec3(a[0])), glm::length(glm::vec3(a[1])), glm::length(glm::vec3(a[2])));
+    const glm::vec3 sb(glm::length(glm::vec3(b[0])), glm::length(glm::vec3(b[1])), glm::length(glm::vec3(b[2])));
+    const glm::mat3 ra(glm::vec3(a[0]) / sa.x, glm::vec3(a[1]) / sa.y, glm::vec3(a[2]) / sa.z);
+    const glm::mat3 rb(glm::vec3(b[0]) / sb.x, glm::vec3(b[1]) / sb.y, glm::vec3(b[2]) / sb.z);
+
+    const glm::mat3 r = glm::mat3_cast(glm::slerp(glm::quat_cast(ra), glm::quat_cast(rb), alpha));
+    const glm::vec3 s = glm::mix(sa, sb, alpha);
+
+    glm::mat4 m(r);
+    m[0] *= s.x;
+    m[1] *= s.y;
+    m[2] *= s.z;
+    m[3] = glm::mix(a[3], b[3], alpha);
+    return m;
+}
+
+void interpolateStates(const SimState &prev, const SimState &curr, float alpha,
+                       std::vector<glm::mat4> &out) {
+    out.resize(curr.models.size());
+    for (size_t i = 0; i < curr.models.size(); ++i)
+        out[i] = i < prev.models.size() ? interpolateModel(prev.models[i], curr.models[i], alpha)
+                                        : curr.models[i];
+}
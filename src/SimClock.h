@@ -0,0 +1,63 @@
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Horloge de simulation à pas fixe, découplée de l'affichage : le temps
+// réel écoulé (multiplié par le facteur d'accélération) est accumulé et
+// consommé par pas de durée constante. Le reste sert à interpoler entre
+// les deux derniers états simulés.
+class SimClock
+{
+public:
+    explicit SimClock(double step = 1.0 / 120.0, int maxStepsPerFrame = 16);
+
+    // Ajoute le temps réel écoulé, renvoie le nombre de pas à simuler.
+    int advance(double realSeconds);
+
+    double step() const { return m_step; }
+    double time() const { return m_time; }    // temps du dernier état simulé
+    // Position du rendu entre l'avant-dernier (0) et le dernier état (1).
+    float alpha() const { return float(m_accumulator / m_step); }
+
+    double warp() const { return m_warp; }
+    void setWarp(double warp) { m_warp = warp; }
+    bool paused() const { return m_paused; }
+    void setPaused(bool paused) { m_paused = paused; }
+
+private:
+    double m_step;
+    int m_maxSteps;   // au-delà, on ralentit plutôt que de s'effondrer
+    double m_time = 0.0;
+    double m_accumulator = 0.0;
+    double m_warp = 1.0;
+    bool m_paused = false;
+};
+
+// Matrices modèle de tous les corps à un instant simulé.
+struct SimState {
+    double time = 0.0;
+    std::vector<glm::mat4> models;
+};
+
+// Ce que le thread de simulation publie au rendu : les deux derniers états
+// et de quoi prolonger alpha jusqu'à l'instant de l'affichage.
+struct SimFrame {
+    SimState prev, curr;
+    float alpha = 0.f;        // alpha de l'horloge à la publication
+    double publishedAt = 0.0; // temps réel de la publication
+    double stepsPerSecond = 0.0; // pas simulés par seconde réelle (0 en pause)
+
+    float alphaAt(double now) const {
+        const double a = alpha + (now - publishedAt) * stepsPerSecond;
+        return float(a < 1.0 ? a : 1.0);
+    }
+};
+
+// Interpole chaque matrice : translation et échelle linéaires, rotation
+// sphérique. Les corps absents de prev (ajoutés entre-temps) prennent curr.
+void interpolateStates(const SimState &prev, const SimState &curr, float alpha,
+                       std::vector<glm::mat4> &out);
+
+#endif // SIMCLOCK_H
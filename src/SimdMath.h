@@ -0,0 +1,101 @@
+#ifndef SIMDMATH_H
+#define SIMDMATH_H
+
+// Petite couche d'abstraction SIMD partagée par les noyaux de simulation.
+// SIMD_WIDTH vaut 8 (AVX2), 4 (SSE2) ou n'est pas défini (scalaire seul).
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIMD_WIDTH 4
+#endif
+
+#ifdef SIMD_WIDTH
+
+#if SIMD_WIDTH == 8
+typedef __m256 vfloat;
+static inline vfloat vset(float x) { return _mm256_set1_ps(x); }
+static inline vfloat vload(const float *p) { return _mm256_loadu_ps(p); }
+static inline void vstore(float *p, vfloat a) { _mm256_storeu_ps(p, a); }
+static inline vfloat vadd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat vdiv(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+static inline vfloat vsqrt(vfloat a) { return _mm256_sqrt_ps(a); }
+static inline vfloat vmin(vfloat a, vfloat b) { return _mm256_min_ps(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b) { return _mm256_max_ps(a, b); }
+static inline vfloat vand(vfloat a, vfloat b) { return _mm256_and_ps(a, b); }
+static inline vfloat vandnot(vfloat a, vfloat b) { return _mm256_andnot_ps(a, b); }
+static inline vfloat vor(vfloat a, vfloat b) { return _mm256_or_ps(a, b); }
+static inline vfloat vxor(vfloat a, vfloat b) { return _mm256_xor_ps(a, b); }
+static inline vfloat vcmpeq(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline vfloat vcmpge(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline vfloat vcmplt(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline int vmovemask(vfloat a) { return _mm256_movemask_ps(a); }
+static inline vfloat vround(vfloat a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline vfloat vfloor(vfloat a) { return _mm256_floor_ps(a); }
+#else
+typedef __m128 vfloat;
+static inline vfloat vset(float x) { return _mm_set1_ps(x); }
+static inline vfloat vload(const float *p) { return _mm_loadu_ps(p); }
+static inline void vstore(float *p, vfloat a) { _mm_storeu_ps(p, a); }
+static inline vfloat vadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vdiv(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+static inline vfloat vsqrt(vfloat a) { return _mm_sqrt_ps(a); }
+static inline vfloat vmin(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+static inline vfloat vand(vfloat a, vfloat b) { return _mm_and_ps(a, b); }
+static inline vfloat vandnot(vfloat a, vfloat b) { return _mm_andnot_ps(a, b); }
+static inline vfloat vor(vfloat a, vfloat b) { return _mm_or_ps(a, b); }
+static inline vfloat vxor(vfloat a, vfloat b) { return _mm_xor_ps(a, b); }
+static inline vfloat vcmpeq(vfloat a, vfloat b) { return _mm_cmpeq_ps(a, b); }
+static inline vfloat vcmpge(vfloat a, vfloat b) { return _mm_cmpge_ps(a, b); }
+static inline vfloat vcmplt(vfloat a, vfloat b) { return _mm_cmplt_ps(a, b); }
+static inline int vmovemask(vfloat a) { return _mm_movemask_ps(a); }
+// SSE2 n'a pas d'arrondi vectoriel : conversion entière (mode au plus proche)
+static inline vfloat vround(vfloat a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+static inline vfloat vfloor(vfloat a) {
+    vfloat r = vround(a);
+    return vsub(r, vand(_mm_cmpgt_ps(r, a), vset(1.f)));
+}
+#endif
+
+static inline vfloat vselect(vfloat mask, vfloat a, vfloat b) { return vor(vand(mask, a), vandnot(mask, b)); }
+static inline vfloat vneg(vfloat a) { return vxor(a, vset(-0.f)); }
+
+// sin et cos simultanés : réduction de Cody-Waite sur pi/2 puis polynômes
+// minimax de Cephes sur [-pi/4, pi/4]. Aucun branchement, erreur ~1e-7.
+static inline void vsincos(vfloat x, vfloat &s, vfloat &c) {
+    const vfloat j = vround(vmul(x, vset(0.63661977236f)));
+    vfloat r = vsub(x, vmul(j, vset(1.5703125f)));
+    r = vsub(r, vmul(j, vset(4.837512969970703125e-4f)));
+    r = vsub(r, vmul(j, vset(7.54978995489188216e-8f)));
+    const vfloat r2 = vmul(r, r);
+
+    vfloat ps = vadd(vset(8.3321608736e-3f), vmul(r2, vset(-1.9515295891e-4f)));
+    ps = vadd(vset(-1.6666654611e-1f), vmul(r2, ps));
+    ps = vadd(r, vmul(vmul(r, r2), ps));
+
+    vfloat pc = vadd(vset(-1.388731625493765e-3f), vmul(r2, vset(2.443315711809948e-5f)));
+    pc = vadd(vset(4.166664568298827e-2f), vmul(r2, pc));
+    pc = vadd(vsub(vset(1.f), vmul(vset(0.5f), r2)), vmul(vmul(r2, r2), pc));
+
+    // quadrant q = j mod 4
+    const vfloat q = vsub(j, vmul(vset(4.f), vfloor(vmul(j, vset(0.25f)))));
+    const vfloat q1 = vcmpeq(q, vset(1.f));
+    const vfloat q2 = vcmpeq(q, vset(2.f));
+    const vfloat q3 = vcmpeq(q, vset(3.f));
+    const vfloat swap = vor(q1, q3);
+    const vfloat signBit = vset(-0.f);
+
+    s = vxor(vselect(swap, pc, ps), vand(vcmpge(q, vset(2.f)), signBit));
+    c = vxor(vselect(swap, ps, pc), vand(vor(q1, q2), signBit));
+}
+
+#endif // SIMD_WIDTH
+
+#endif // SIMDMATH_H
@@ -0,0 +1,118 @@
+#include "TextureArray.h"
+#include "AssetArchive.h"
+#include "TextureCache.h"
+
+#include <iostream>
+#include "stb_image.h"
+
+int TextureArray::addLayer(const std::string &filename, MipFilter filter) {
+    m_files.push_back(filename);
+    m_filters.push_back(filter);
+    return int(m_files.size()) - 1;
+}
+
+std::vector<unsigned char> TextureArray::loadResampled(const std::string &filename, int outWidth, int outHeight,
+                                                       const AssetArchive *archive) {
+    std::vector<unsigned char> out(size_t(outWidth) * outHeight * 3, 0);
+
+    int width, height, numComponents;
+    AssetSpan packed;
+    unsigned char *data = archive && archive->find(filename, packed)
+        ? stbi_load_from_memory(packed.data, int(packed.size), &width, &height, &numComponents, 3)
+        : stbi_load(filename.c_str(), &width, &height, &numComponents, 3);
+    if (!data) {
+        std::cerr << "ERROR: cannot load texture " << filename << std::endl;
+        return out;
+    }
+
+    for (int y = 0; y < outHeight; ++y) {
+        // centres de texels alignés entre source et destination
+        float sy = (float(y) + 0.5f) * float(height) / float(outHeight) - 0.5f;
+        int y0 = sy < 0.f ? 0 : int(sy);
+        int y1 = y0 + 1 < height ? y0 + 1 : height - 1;
+        float fy = sy < 0.f ? 0.f : sy - float(y0);
+
+        for (int x = 0; x < outWidth; ++x) {
+            float sx = (float(x) + 0.5f) * float(width) / float(outWidth) - 0.5f;
+            int x0 = sx < 0.f ? 0 : int(sx);
+            int x1 = x0 + 1 < width ? x0 + 1 : width - 1;
+            float fx = sx < 0.f ? 0.f : sx - float(x0);
+
+            for (int c = 0; c < 3; ++c) {
+                float a = data[(size_t(y0) * width + x0) * 3 + c];
+                float b = data[(size_t(y0) * width + x1) * 3 + c];
+                float d = data[(size_t(y1) * width + x0) * 3 + c];
+                float e = data[(size_t(y1) * width + x1) * 3 + c];
+                float top = a + (b - a) * fx;
+                float bottom = d + (e - d) * fx;
+                out[(size_t(y) * outWidth + x) * 3 + c] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+
+    stbi_image_free(data);
+    return out;
+}
+
+GLuint TextureArray::build() {
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
+
+    // trilinéaire dès qu'il y a des mipmaps : les planètes lointaines lisent un petit niveau
+    const int levels = m_mipMode == MipMode::None ? 1 : mipLevelCount(m_width, m_height);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    m_residentBytes = 0;
+    for (int level = 0, w = m_width, h = m_height; level < levels; ++level) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGB8, w, h, GLsizei(m_files.size()),
+                     0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        m_residentBytes += size_t(w) * h * 3 * m_files.size();
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    // le cache dépend de la résolution commune, de l'origine des mipmaps et de leur filtre
+    const std::string mode = std::to_string(m_width) + "x" + std::to_string(m_height) + "-" + mipModeName(m_mipMode);
+    const size_t storedLevels = m_mipMode == MipMode::Cpu ? size_t(levels) : 1;
+    for (size_t layer = 0; layer < m_files.size(); ++layer) {
+        const bool box = m_mipMode == MipMode::Cpu && m_filters[layer] == MipFilter::Box;
+        const std::string variant = box ? mode + "-" + mipFilterName(MipFilter::Box) : mode;
+        CachedTexture cached;
+        if (m_cache && m_cache->load(m_files[layer], variant, cached) && cached.format == kCacheFormatRGB8
+            && cached.channels == 3 && cached.levels.size() == storedLevels) {
+            // envoi direct depuis le fichier projeté, sans décodage
+            for (size_t level = 0; level < cached.levels.size(); ++level) {
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, GLint(level), 0, 0, GLint(layer),
+                                cached.levels[level].width, cached.levels[level].height, 1,
+                                GL_RGB, GL_UNSIGNED_BYTE, cached.levels[level].data);
+            }
+            continue;
+        }
+
+        std::vector<MipLevel> chain(1);
+        chain[0].width = m_width;
+        chain[0].height = m_height;
+        chain[0].pixels = loadResampled(m_files[layer], m_width, m_height, m_archive);
+        if (m_mipMode == MipMode::Cpu) {
+            std::vector<MipLevel> mips = buildMipChain(chain[0].pixels.data(), m_width, m_height, 3, true, m_filters[layer]);
+            chain.insert(chain.end(), mips.begin(), mips.end());
+        }
+        for (size_t level = 0; level < chain.size(); ++level) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, GLint(level), 0, 0, GLint(layer),
+                            chain[level].width, chain[level].height, 1,
+                            GL_RGB, GL_UNSIGNED_BYTE, chain[level].pixels.data());
+        }
+        if (m_cache)
+            m_cache->store(m_files[layer], variant, chain, 3);
+    }
+    if (m_mipMode == MipMode::Gpu)
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY); // une seule chaîne pour toutes les couches
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return texID;
+}
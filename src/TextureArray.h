@@ -0,0 +1,57 @@
+#ifndef TEXTUREARRAY_H
+#define TEXTUREARRAY_H
+
+#include <string>
+#include <vector>
+#include <glad/gl.h>
+
+#include "MipChain.h"
+
+class AssetArchive;
+class TextureCache;
+
+// Regroupe plusieurs images dans une seule GL_TEXTURE_2D_ARRAY.
+// Chaque image est rééchantillonnée à la résolution commune ; la chaîne de
+// mipmaps vient du GPU, du CPU ou est absente selon le MipMode.
+class TextureArray {
+public:
+    TextureArray(int width = 1024, int height = 512) : m_width(width), m_height(height) {}
+
+    // Renvoie l'indice de couche attribué à l'image (chargée au build()).
+    // filter : réduction des mipmaps de cette couche en MipMode::Cpu
+    // (glGenerateMipmap filtre toutes les couches de la même façon).
+    int addLayer(const std::string &filename, MipFilter filter = MipFilter::Tent);
+    // Décode, rééchantillonne et envoie toutes les couches ; renvoie la texture.
+    GLuint build();
+
+    int layerCount() const { return int(m_files.size()); }
+
+    // À choisir avant build() ; MipMode::Gpu par défaut.
+    void setMipMode(MipMode mode) { m_mipMode = mode; }
+    // Cache de textures prétraitées : build() y lit les couches à jour et y
+    // écrit celles qu'il a dû décoder. nullptr : toujours décoder.
+    void setCache(TextureCache *cache) { m_cache = cache; }
+    // Les images présentes dans l'archive y sont lues plutôt que sur disque.
+    void setArchive(const AssetArchive *archive) { m_archive = archive; }
+
+    // Octets occupés sur le GPU après build(), tous niveaux compris.
+    size_t residentBytes() const { return m_residentBytes; }
+
+    // Décode une image et la rééchantillonne (bilinéaire) en outWidth x outHeight,
+    // RGB 8 bits ; image noire si le fichier est illisible. Lue dans archive
+    // si elle s'y trouve.
+    static std::vector<unsigned char> loadResampled(const std::string &filename, int outWidth, int outHeight,
+                                                    const AssetArchive *archive = nullptr);
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<std::string> m_files;
+    std::vector<MipFilter> m_filters;  // par couche
+    MipMode m_mipMode = MipMode::Gpu;
+    TextureCache *m_cache = nullptr;
+    const AssetArchive *m_archive = nullptr;
+    size_t m_residentBytes = 0;
+};
+
+#endif // TEXTUREARRAY_H
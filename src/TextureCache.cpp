@@ -0,0 +1,190 @@
+#include "TextureCache.h"
+#include "AssetArchive.h"
+#include "BlockCompression.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+static const char kMagic[4] = { 'S', 'T', 'X', 'C' };
+static const uint32_t kVersion = 1;
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint32_t format;
+    uint32_t channels;
+    uint32_t levelCount;
+    uint32_t pathLength;  // chemin source qui suit l'en-tête, sans '\0'
+};
+
+struct CacheLevel {
+    uint32_t width, height;
+    uint64_t offset, size;  // depuis le début du fichier
+};
+
+static size_t align16(size_t n) { return (n + 15) & ~size_t(15); }
+
+// Taille exacte d'un niveau w x h dans ce format ; false pour un format ou
+// des dimensions impossibles (entrée corrompue).
+static bool levelBytes(uint32_t format, uint32_t channels, uint32_t width, uint32_t height, uint64_t &bytes) {
+    if (width == 0 || height == 0 || width > 65536 || height > 65536)
+        return false;
+    switch (format) {
+    case kCacheFormatRGB8:
+        if (channels == 0 || channels > 4)
+            return false;
+        bytes = uint64_t(width) * height * channels;
+        return true;
+    case kCacheFormatBC1:
+        bytes = blockCompressedSize(int(width), int(height));
+        return true;
+    default:
+        return false;
+    }
+}
+
+// FNV-1a 64 bits
+static uint64_t hashString(const std::string &s) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < s.size(); ++i) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+TextureCache::TextureCache(const std::string &directory) : m_directory(directory) {
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+}
+
+std::string TextureCache::entryPath(const std::string &source, const std::string &variant) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.stx", (unsigned long long)hashString(source + '|' + variant));
+    return m_directory + "/" + name;
+}
+
+bool TextureCache::sourceStamp(const std::string &source, unsigned long long &size, long long &mtime) const {
+    size_t packedSize;
+    uint64_t hash;
+    if (m_archive && m_archive->contains(source, packedSize, hash)) {
+        // l'empreinte du contenu tient lieu de date : reconstruire l'archive
+        // ne périme que les textures dont la source a vraiment changé
+        size = packedSize;
+        mtime = (long long)hash;
+        return true;
+    }
+    return fileStamp(source, size, mtime);
+}
+
+bool TextureCache::load(const std::string &source, const std::string &variant, CachedTexture &out) {
+    ++m_misses;  // annulé en cas de succès
+    unsigned long long size;
+    long long mtime;
+    if (!sourceStamp(source, size, mtime) || !out.file.open(entryPath(source, variant)))
+        return false;
+
+    const unsigned char *base = out.file.data();
+    const size_t fileSize = out.file.size();
+    CacheHeader header;
+    if (fileSize < sizeof(header))
+        return false;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion
+        || header.sourceSize != size || header.sourceMtime != mtime
+        || header.pathLength != source.size()
+        || align16(sizeof(header) + header.pathLength) + size_t(header.levelCount) * sizeof(CacheLevel) > fileSize
+        || std::memcmp(base + sizeof(header), source.data(), source.size()) != 0) {
+        out.file.close();
+        return false;
+    }
+
+    const unsigned char *table = base + align16(sizeof(header) + header.pathLength);
+    out.format = header.format;
+    out.channels = int(header.channels);
+    out.levels.resize(header.levelCount);
+    for (uint32_t l = 0; l < header.levelCount; ++l) {
+        CacheLevel level;
+        std::memcpy(&level, table + l * sizeof(CacheLevel), sizeof(level));
+        // la taille doit correspondre aux dimensions : c'est tout ce que lira glTexSubImage
+        uint64_t expected;
+        if (!levelBytes(header.format, header.channels, level.width, level.height, expected)
+            || level.size != expected || level.offset > fileSize || level.size > fileSize - level.offset) {
+            out.file.close();
+            return false;
+        }
+        out.levels[l].width = int(level.width);
+        out.levels[l].height = int(level.height);
+        out.levels[l].data = base + level.offset;
+        out.levels[l].size = size_t(level.size);
+    }
+    --m_misses;
+    ++m_hits;
+    return true;
+}
+
+bool TextureCache::store(const std::string &source, const std::string &variant,
+                         const std::vector<MipLevel> &levels, int channels, uint32_t format) {
+    unsigned long long size;
+    long long mtime;
+    if (!sourceStamp(source, size, mtime))
+        return false;
+
+    CacheHeader header;
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.sourceSize = size;
+    header.sourceMtime = mtime;
+    header.format = format;
+    header.channels = uint32_t(channels);
+    header.levelCount = uint32_t(levels.size());
+    header.pathLength = uint32_t(source.size());
+
+    // texels alignés sur 16 octets : lisibles tels quels depuis la projection
+    const size_t tableOffset = align16(sizeof(header) + source.size());
+    std::vector<CacheLevel> table(levels.size());
+    size_t offset = align16(tableOffset + table.size() * sizeof(CacheLevel));
+    for (size_t l = 0; l < levels.size(); ++l) {
+        table[l].width = uint32_t(levels[l].width);
+        table[l].height = uint32_t(levels[l].height);
+        table[l].offset = offset;
+        table[l].size = levels[l].pixels.size();
+        offset = align16(offset + levels[l].pixels.size());
+    }
+
+    // écriture dans un fichier temporaire puis renommage : jamais d'entrée à moitié écrite
+    const std::string path = entryPath(source, variant), temp = path + ".tmp";
+    {
+        std::ofstream file(temp.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "WARNING: cannot write texture cache entry " << temp << std::endl;
+            return false;
+        }
+        const char zeros[16] = { 0 };
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(source.data(), std::streamsize(source.size()));
+        file.write(zeros, std::streamsize(tableOffset - sizeof(header) - source.size()));
+        file.write(reinterpret_cast<const char *>(table.data()), std::streamsize(table.size() * sizeof(CacheLevel)));
+        size_t written = tableOffset + table.size() * sizeof(CacheLevel);
+        for (size_t l = 0; l < levels.size(); ++l) {
+            file.write(zeros, std::streamsize(table[l].offset - written));
+            file.write(reinterpret_cast<const char *>(levels[l].pixels.data()), std::streamsize(levels[l].pixels.size()));
+            written = table[l].offset + levels[l].pixels.size();
+        }
+        if (!file)
+            return false;
+    }
+    std::remove(path.c_str());  // rename n'écrase pas sous Windows
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,70 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "MipChain.h"
+
+class AssetArchive;
+
+// Format des texels d'une entrée du cache.
+enum : uint32_t {
+    kCacheFormatRGB8 = 0,  // 3 octets par texel, non compressé
+    kCacheFormatBC1 = 1    // blocs DXT1 (voir BlockCompression.h)
+};
+
+// Entrée chargée : chaque niveau pointe directement dans le fichier
+// projeté, prêt pour glTexImage/glTexSubImage sans décodage ni copie.
+struct CachedTexture {
+    struct Level {
+        int width, height;
+        const unsigned char *data;
+        size_t size;
+    };
+    uint32_t format = kCacheFormatRGB8;
+    int channels = 0;
+    std::vector<Level> levels;
+    MappedFile file;
+};
+
+// Textures prétraitées (décodées, rééchantillonnées, mipmaps) stockées dans
+// un dossier, un fichier par image source et variante : en-tête, chemin
+// source, table des niveaux (dimensions, position, taille), puis les
+// texels. Une entrée est périmée dès que la taille ou la date de
+// modification de la source ne correspondent plus ; elle est alors
+// reconstruite par l'appelant et réécrite. Utilisable depuis plusieurs
+// threads à la fois (entrées distinctes).
+class TextureCache
+{
+public:
+    // Crée le dossier au besoin.
+    explicit TextureCache(const std::string &directory);
+
+    // variant distingue les versions d'une même source (résolution, mode de
+    // mipmaps...). Renvoie false si l'entrée manque ou est périmée.
+    bool load(const std::string &source, const std::string &variant, CachedTexture &out);
+    // levels[0] est l'image pleine résolution.
+    bool store(const std::string &source, const std::string &variant,
+               const std::vector<MipLevel> &levels, int channels, uint32_t format = kCacheFormatRGB8);
+
+    // Sources présentes dans l'archive : datées par l'empreinte de leur
+    // contenu, enregistrée dans l'index de l'archive.
+    void setArchive(const AssetArchive *archive) { m_archive = archive; }
+
+    unsigned hits() const { return m_hits; }
+    unsigned misses() const { return m_misses; }
+
+private:
+    std::string entryPath(const std::string &source, const std::string &variant) const;
+    bool sourceStamp(const std::string &source, unsigned long long &size, long long &mtime) const;
+
+    std::string m_directory;
+    const AssetArchive *m_archive = nullptr;
+    std::atomic<unsigned> m_hits{0}, m_misses{0};
+};
+
+#endif // TEXTURECACHE_H
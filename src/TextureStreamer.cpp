@@ -0,0 +1,260 @@
+#include "TextureStreamer.h"
+#include "BlockCompression.h"
+#include "TextureArray.h"
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const int kPlaceholderSize = 16;  // les niveaux de cette taille ou moins partent en gris
+static const unsigned char kPlaceholderGrey = 128;
+
+TextureStreamer::TextureStreamer(int width, int height, unsigned decodeThreads)
+    : m_width(width), m_height(height), m_decodeThreads(std::max(1u, decodeThreads)) {}
+
+TextureStreamer::~TextureStreamer() {
+    m_stopping = true;
+    for (size_t i = 0; i < m_threads.size(); ++i)
+        m_threads[i].join();
+    if (m_pbo)
+        glDeleteBuffers(1, &m_pbo);
+}
+
+int TextureStreamer::addLayer(const std::string &filename, MipFilter filter) {
+    m_layers.push_back(Layer());
+    m_layers.back().file = filename;
+    m_layers.back().filter = filter;
+    return int(m_layers.size()) - 1;
+}
+
+size_t TextureStreamer::rowBytes(int width) const {
+    return m_compressed ? blockRowBytes(width) : size_t(width) * 3;
+}
+
+int TextureStreamer::rowCount(int height) const {
+    return m_compressed ? (height + 3) / 4 : height;
+}
+
+// Même clé que TextureArray pour RGB8 : les deux chemins partagent le cache.
+std::string TextureStreamer::cacheVariant(int width, int height, bool compressed, MipFilter filter) {
+    const std::string variant = std::to_string(width) + "x" + std::to_string(height) + "-"
+                              + (compressed ? "bc1" : mipModeName(MipMode::Cpu));
+    return filter == MipFilter::Box ? variant + "-" + mipFilterName(filter) : variant;
+}
+
+GLuint TextureStreamer::start(TextureCache *cache) {
+    m_cache = cache;
+    m_levelCount = mipLevelCount(m_width, m_height);
+    const GLsizei layers = GLsizei(m_layers.size());
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_levelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // toute la chaîne est allouée d'emblée ; seuls les petits niveaux sont remplis
+    m_placeholderLevel = m_levelCount - 1;
+    std::vector<unsigned char> grey;
+    for (int level = 0, w = m_width, h = m_height; level < m_levelCount; ++level) {
+        const size_t layerBytes = size_t(rowCount(h)) * rowBytes(w);
+        if (m_compressed) {
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, w, h, layers, 0,
+                                   GLsizei(layerBytes * m_layers.size()), nullptr);
+        } else {
+            // texels RGB côté CPU, stockés en RGBA8 (alpha à 1) : format natif des GPU
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, w, h, layers, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        }
+        m_residentBytes += (m_compressed ? layerBytes : size_t(w) * h * 4) * m_layers.size();
+        if (std::max(w, h) <= kPlaceholderSize) {
+            m_placeholderLevel = std::min(m_placeholderLevel, level);
+            grey.assign(size_t(w) * h * 3, kPlaceholderGrey);
+            if (m_compressed) {
+                const std::vector<unsigned char> block = encodeBC1(grey.data(), w, h, 3);
+                std::vector<unsigned char> blocks;
+                for (size_t i = 0; i < m_layers.size(); ++i)
+                    blocks.insert(blocks.end(), block.begin(), block.end());
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, w, h, layers,
+                                          GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GLsizei(blocks.size()), blocks.data());
+            } else {
+                grey.resize(grey.size() * m_layers.size(), kPlaceholderGrey);
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, w, h, layers, GL_RGB, GL_UNSIGNED_BYTE, grey.data());
+            }
+        }
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    for (size_t i = 0; i < m_layers.size(); ++i)
+        m_layers[i].complete = m_placeholderLevel;
+    m_remainingLayers = m_layers.size();
+
+    const unsigned threads = std::min<unsigned>(m_decodeThreads, unsigned(m_layers.size()));
+    for (unsigned i = 0; i < threads; ++i)
+        m_threads.push_back(std::thread(&TextureStreamer::decodeLoop, this));
+    return m_texture;
+}
+
+void TextureStreamer::decodeLoop() {
+    while (!m_stopping) {
+        const size_t layer = m_nextToDecode++;
+        if (layer >= m_layers.size())
+            return;
+        decodeLayer(layer);
+    }
+}
+
+// Thread de décodage : ne touche qu'à sa couche avant de la publier dans m_ready.
+void TextureStreamer::decodeLayer(size_t index) {
+    Layer &layer = m_layers[index];
+    const std::string key = cacheVariant(m_width, m_height, m_compressed, layer.filter);
+    const uint32_t format = m_compressed ? kCacheFormatBC1 : kCacheFormatRGB8;
+
+    std::shared_ptr<CachedTexture> cached = std::make_shared<CachedTexture>();
+    if (m_cache && m_cache->load(layer.file, key, *cached) && cached->format == format
+        && cached->channels == 3 && int(cached->levels.size()) == m_levelCount) {
+        for (size_t l = 0; l < cached->levels.size(); ++l) {
+            const Level level = { cached->levels[l].width, cached->levels[l].height, cached->levels[l].data };
+            layer.levels.push_back(level);
+        }
+        layer.cached = cached;
+    } else {
+        layer.decoded.resize(1);
+        layer.decoded[0].width = m_width;
+        layer.decoded[0].height = m_height;
+        layer.decoded[0].pixels = TextureArray::loadResampled(layer.file, m_width, m_height, m_archive);
+        std::vector<MipLevel> mips = buildMipChain(layer.decoded[0].pixels.data(), m_width, m_height, 3, true, layer.filter);
+        layer.decoded.insert(layer.decoded.end(), mips.begin(), mips.end());
+        if (m_compressed) {
+            // entrée absente du cache (textureCompressor non lancé) : compression sur place
+            for (size_t l = 0; l < layer.decoded.size(); ++l) {
+                MipLevel &level = layer.decoded[l];
+                level.pixels = encodeBC1(level.pixels.data(), level.width, level.height, 3);
+            }
+        }
+        if (m_cache)
+            m_cache->store(layer.file, key, layer.decoded, 3, format);
+        for (size_t l = 0; l < layer.decoded.size(); ++l) {
+            const Level level = { layer.decoded[l].width, layer.decoded[l].height, layer.decoded[l].pixels.data() };
+            layer.levels.push_back(level);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    m_ready.push_back(index);
+}
+
+void TextureStreamer::update(size_t byteBudget) {
+    m_bytesLastFrame = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_readyMutex);
+        for (size_t i = 0; i < m_ready.size(); ++i) {
+            Layer &layer = m_layers[m_ready[i]];
+            layer.nextLevel = int(layer.levels.size()) - 1;
+            layer.nextRow = 0;
+        }
+        m_ready.clear();
+    }
+
+    // au moins une ligne du plus grand niveau, pour avancer même avec un budget minuscule
+    const size_t capacity = std::max(byteBudget, rowBytes(m_width));
+    struct Upload {
+        int layer, level, row, rows;
+        size_t offset;
+    };
+    std::vector<Upload> uploads;
+    unsigned char *mapped = nullptr;
+    size_t used = 0;
+
+    for (;;) {
+        // le niveau le plus grossier d'abord, toutes couches confondues
+        int best = -1;
+        for (size_t i = 0; i < m_layers.size(); ++i) {
+            if (m_layers[i].nextLevel >= 0 && (best < 0 || m_layers[i].nextLevel > m_layers[best].nextLevel))
+                best = int(i);
+        }
+        if (best < 0)
+            break;
+
+        Layer &layer = m_layers[best];
+        const Level &level = layer.levels[layer.nextLevel];
+        const size_t levelRowBytes = rowBytes(level.width);
+        const int levelRows = rowCount(level.height);
+        int rows = std::min(levelRows - layer.nextRow, int((byteBudget > used ? byteBudget - used : 0) / levelRowBytes));
+        if (rows == 0) {
+            if (used > 0)
+                break;
+            rows = 1;
+        }
+
+        if (!mapped) {
+            if (!m_pbo)
+                glGenBuffers(1, &m_pbo);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+            // orphelinage : le driver n'attend pas que les envois précédents soient lus
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(capacity), nullptr, GL_STREAM_DRAW);
+            m_pboCapacity = capacity;
+            mapped = static_cast<unsigned char *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(capacity),
+                                                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+            if (!mapped) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                return;
+            }
+        }
+
+        const size_t bytes = size_t(rows) * levelRowBytes;
+        std::memcpy(mapped + used, level.data + size_t(layer.nextRow) * levelRowBytes, bytes);
+        const Upload upload = { best, layer.nextLevel, layer.nextRow, rows, used };
+        uploads.push_back(upload);
+        used += bytes;
+
+        layer.nextRow += rows;
+        if (layer.nextRow == levelRows) {
+            layer.complete = std::min(layer.complete, layer.nextLevel);
+            --layer.nextLevel;
+            layer.nextRow = 0;
+            if (layer.nextLevel < 0) {
+                // tout est envoyé à la fin de cette image : libère les données CPU
+                --m_remainingLayers;
+            }
+        }
+    }
+    if (!mapped)
+        return;
+
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t k = 0; k < uploads.size(); ++k) {
+        const Upload &u = uploads[k];
+        const Level &level = m_layers[u.layer].levels[u.level];
+        // avec un PBO lié, le « pointeur » est un décalage dans le buffer
+        const void *offset = reinterpret_cast<const void *>(u.offset);
+        if (m_compressed) {
+            // lignes de blocs : la dernière peut déborder d'une hauteur non multiple de 4
+            const int y = u.row * 4, height = std::min(u.rows * 4, level.height - y);
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, u.level, 0, y, u.layer, level.width, height, 1,
+                                      GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GLsizei(size_t(u.rows) * rowBytes(level.width)),
+                                      offset);
+        } else {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, u.level, 0, u.row, u.layer, level.width, u.rows, 1,
+                            GL_RGB, GL_UNSIGNED_BYTE, offset);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    m_bytesLastFrame = used;
+
+    for (size_t k = 0; k < uploads.size(); ++k) {
+        Layer &layer = m_layers[uploads[k].layer];
+        if (layer.nextLevel < 0 && !layer.levels.empty()) {
+            layer.levels.clear();
+            std::vector<MipLevel>().swap(layer.decoded);
+            layer.cached.reset();
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/gl.h>
+
+#include "MipChain.h"
+
+class AssetArchive;
+class TextureCache;
+struct CachedTexture;
+
+// Chargement progressif d'une GL_TEXTURE_2D_ARRAY : start() alloue la
+// texture et la remplit d'un gris de quelques texels, puis des threads
+// décodent les images (ou les lisent dans le cache) avec leur chaîne de
+// mipmaps. À chaque image, update() envoie au GPU, via un pixel buffer
+// object, au plus un budget d'octets, du niveau le plus grossier vers le
+// plus fin. minLod(layer) indique au shader le niveau le plus fin déjà
+// complet de chaque couche. En mode compressé, les niveaux sont des blocs
+// BC1 (lus dans le cache, préparés par textureCompressor, ou compressés à
+// la volée) envoyés par lignes de blocs.
+class TextureStreamer
+{
+public:
+    TextureStreamer(int width = 1024, int height = 512, unsigned decodeThreads = 2);
+    ~TextureStreamer();
+
+    // BC1 plutôt que RGBA8 ; l'appelant vérifie GLAD_GL_EXT_texture_compression_s3tc.
+    // À fixer avant start().
+    void setCompressed(bool compressed) { m_compressed = compressed; }
+    bool compressed() const { return m_compressed; }
+    // Images lues dans l'archive quand elles y sont ; à fixer avant start().
+    void setArchive(const AssetArchive *archive) { m_archive = archive; }
+
+    // filter : réduction des mipmaps de cette couche (voir MipChain.h).
+    int addLayer(const std::string &filename, MipFilter filter = MipFilter::Tent);
+    // Clé des entrées du cache, partagée avec textureCompressor.
+    static std::string cacheVariant(int width, int height, bool compressed, MipFilter filter = MipFilter::Tent);
+    // Alloue la texture, envoie les substituts et lance le décodage ;
+    // renvoie la texture, utilisable immédiatement. L'appelant la détruit :
+    // elle survit au TextureStreamer une fois tout envoyé.
+    GLuint start(TextureCache *cache = nullptr);
+
+    // À appeler une fois par image, thread GL.
+    void update(size_t byteBudget);
+
+    GLuint texture() const { return m_texture; }
+    float minLod(int layer) const { return float(m_layers[layer].complete); }
+    bool done() const { return m_remainingLayers == 0; }
+    size_t bytesUploadedLastFrame() const { return m_bytesLastFrame; }
+    size_t residentBytes() const { return m_residentBytes; }
+
+private:
+    struct Level {
+        int width, height;
+        const unsigned char *data;  // RGB8 ou blocs BC1 selon m_compressed
+    };
+    // Une couche décodée, en attente ou en cours d'envoi.
+    struct Layer {
+        std::string file;
+        MipFilter filter = MipFilter::Tent;
+        int complete = 0;        // niveau le plus fin entièrement envoyé
+        int nextLevel = -1;      // niveau en cours d'envoi, -1 : pas encore décodé
+        int nextRow = 0;         // première ligne (de texels ou de blocs) restant à envoyer
+        std::vector<Level> levels;
+        std::vector<MipLevel> decoded;          // niveaux décodés (sans cache)
+        std::shared_ptr<CachedTexture> cached;  // ou fichier projeté du cache
+    };
+
+    void decodeLoop();
+    void decodeLayer(size_t layer);
+    // Unité d'envoi : une ligne de texels, ou de blocs en mode compressé.
+    size_t rowBytes(int width) const;
+    int rowCount(int height) const;
+
+    int m_width, m_height, m_levelCount = 1;
+    int m_placeholderLevel = 0;  // premier niveau rempli de gris
+    unsigned m_decodeThreads;
+    bool m_compressed = false;
+    std::vector<Layer> m_layers;
+    TextureCache *m_cache = nullptr;
+    const AssetArchive *m_archive = nullptr;
+
+    GLuint m_texture = 0;
+    GLuint m_pbo = 0;
+    size_t m_pboCapacity = 0;
+    size_t m_bytesLastFrame = 0;
+    size_t m_residentBytes = 0;
+    size_t m_remainingLayers = 0;
+
+    std::vector<std::thread> m_threads;
+    std::atomic<size_t> m_nextToDecode{0};
+    std::atomic<bool> m_stopping{false};
+    std::mutex m_readyMutex;
+    std::vector<size_t> m_ready;  // couches décodées, pas encore prises par update()
+};
+
+#endif // TEXTURESTREAMER_H
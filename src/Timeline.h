@@ -0,0 +1,27 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Chronologie du démarrage : chaque étape est affichée avec l'instant où
+// elle se produit depuis la création, pour voir ce qui se recouvre.
+class Timeline
+{
+public:
+    Timeline() : m_start(Clock::now()) {}
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - m_start).count();
+    }
+    void mark(const std::string &stage) const {
+        std::printf("[%8.1f ms] %s\n", elapsedMs(), stage.c_str());
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point m_start;
+};
+
+#endif // TIMELINE_H
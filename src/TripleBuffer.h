@@ -0,0 +1,39 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Échange sans verrou entre un unique producteur et un unique consommateur.
+// Le producteur écrit dans back() puis publie ; le consommateur récupère la
+// dernière publication avec update() puis lit front(). Aucun ne bloque
+// l'autre : les publications non lues sont simplement écrasées.
+template<typename T>
+class TripleBuffer
+{
+public:
+    // Côté producteur.
+    T &back() { return m_buffers[m_back]; }
+    void publish() {
+        m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    // Côté consommateur : vrai si front() a changé.
+    bool update() {
+        if (!(m_middle.load(std::memory_order_relaxed) & kFresh))
+            return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+    const T &front() const { return m_buffers[m_front]; }
+
+private:
+    static const int kIndex = 3;  // indice du tampon intermédiaire
+    static const int kFresh = 4;  // publié mais pas encore lu
+
+    T m_buffers[3];
+    int m_back = 0;
+    std::atomic<int> m_middle{1};
+    int m_front = 2;
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,493 @@
+#include "VirtualTexture.h"
+#include "MipChain.h"
+#include "TextureArray.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char kMagic[4] = { 'S', 'V', 'T', 'X' };
+static const uint32_t kVersion = 1;
+static const int kFeedbackScale = 8;  // la passe de retour est rendue en 1/8 de la taille de l'écran
+
+struct SvtHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint32_t width, height, tileSize, border, levelCount, reserved;
+};
+
+static size_t align16(size_t n) { return (n + 15) & ~size_t(15); }
+
+static bool isPowerOfTwo(int n) { return n > 0 && (n & (n - 1)) == 0; }
+
+// Niveaux jusqu'à celui qui tient dans une seule tuile.
+static int tileLevelCount(int tilesX, int tilesY) {
+    int levels = 1;
+    while ((tilesX >> (levels - 1)) > 1 || (tilesY >> (levels - 1)) > 1)
+        ++levels;
+    return levels;
+}
+
+bool virtualTextureFileIsCurrent(const std::string &source, const std::string &path,
+                                 int width, int height, int tileSize, int border) {
+    unsigned long long size;
+    long long mtime;
+    MappedFile file;
+    if (!fileStamp(source, size, mtime) || !file.open(path) || file.size() < sizeof(SvtHeader))
+        return false;
+    SvtHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    return std::memcmp(header.magic, kMagic, 4) == 0 && header.version == kVersion
+        && header.sourceSize == size && header.sourceMtime == mtime
+        && int(header.width) == width && int(header.height) == height
+        && int(header.tileSize) == tileSize && int(header.border) == border;
+}
+
+bool buildVirtualTextureFile(const std::string &source, const std::string &path,
+                             int width, int height, int tileSize, int border) {
+    if (!isPowerOfTwo(width) || !isPowerOfTwo(height) || !isPowerOfTwo(tileSize)
+        || width < tileSize || height < tileSize || border < 0 || border >= tileSize) {
+        std::cerr << "ERROR: virtual texture " << width << "x" << height << " with tiles of "
+                  << tileSize << " is not supported (powers of two, at least one tile)" << std::endl;
+        return false;
+    }
+    unsigned long long size;
+    long long mtime;
+    if (!fileStamp(source, size, mtime))
+        return false;
+
+    const int levelCount = tileLevelCount(width / tileSize, height / tileSize);
+    std::vector<MipLevel> levels(1);
+    levels[0].width = width;
+    levels[0].height = height;
+    levels[0].pixels = TextureArray::loadResampled(source, width, height);
+    std::vector<MipLevel> mips = buildMipChain(levels[0].pixels.data(), width, height, 3);
+    levels.insert(levels.end(), mips.begin(), mips.begin() + (levelCount - 1));
+
+    SvtHeader header;
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.sourceSize = size;
+    header.sourceMtime = mtime;
+    header.width = uint32_t(width);
+    header.height = uint32_t(height);
+    header.tileSize = uint32_t(tileSize);
+    header.border = uint32_t(border);
+    header.levelCount = uint32_t(levelCount);
+    header.reserved = 0;
+
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "WARNING: cannot write virtual texture " << temp << std::endl;
+            return false;
+        }
+        const char zeros[16] = { 0 };
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(zeros, std::streamsize(align16(sizeof(header)) - sizeof(header)));
+
+        const int padded = tileSize + 2 * border;
+        std::vector<unsigned char> tile(size_t(padded) * padded * 3);
+        for (int l = 0; l < levelCount; ++l) {
+            const MipLevel &level = levels[l];
+            const int tilesX = std::max(1, (width / tileSize) >> l), tilesY = std::max(1, (height / tileSize) >> l);
+            for (int ty = 0; ty < tilesY; ++ty) {
+                for (int tx = 0; tx < tilesX; ++tx) {
+                    // bordure : repliement horizontal (carte équirectangulaire), bords verticaux répétés
+                    for (int y = 0; y < padded; ++y) {
+                        const int sy = std::min(std::max(ty * tileSize + y - border, 0), level.height - 1);
+                        for (int x = 0; x < padded; ++x) {
+                            const int sx = ((tx * tileSize + x - border) % level.width + level.width) % level.width;
+                            std::memcpy(&tile[(size_t(y) * padded + x) * 3],
+                                        &level.pixels[(size_t(sy) * level.width + sx) * 3], 3);
+                        }
+                    }
+                    file.write(reinterpret_cast<const char *>(tile.data()), std::streamsize(tile.size()));
+                }
+            }
+        }
+        if (!file)
+            return false;
+    }
+    std::remove(path.c_str());  // rename n'écrase pas sous Windows
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+VirtualTexture::VirtualTexture(int atlasSlots) : m_atlasSlots(atlasSlots) {}
+
+VirtualTexture::~VirtualTexture() {
+    if (m_loader.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_loadMutex);
+            m_stopping = true;
+        }
+        m_loadWake.notify_all();
+        m_loader.join();
+    }
+    glDeleteTextures(1, &m_pageTable);
+    glDeleteTextures(1, &m_atlas);
+    glDeleteFramebuffers(1, &m_feedbackFbo);
+    glDeleteRenderbuffers(1, &m_feedbackColor);
+    glDeleteRenderbuffers(1, &m_feedbackDepth);
+    glDeleteBuffers(2, m_feedbackPbo);
+}
+
+int VirtualTexture::addLayer(const std::string &tiledFile) {
+    m_files.push_back(tiledFile);
+    return int(m_files.size()) - 1;
+}
+
+int VirtualTexture::tileIndex(int layer, int level, int x, int y) const {
+    return layer * m_tilesPerLayer + m_levelStart[level] + y * levelTilesX(level) + x;
+}
+
+size_t VirtualTexture::tileBytes() const {
+    const size_t padded = size_t(m_tileSize + 2 * m_border);
+    return padded * padded * 3;
+}
+
+const unsigned char *VirtualTexture::tileData(int tile) const {
+    return m_tileBase[tile / m_tilesPerLayer] + size_t(tile % m_tilesPerLayer) * tileBytes();
+}
+
+bool VirtualTexture::start() {
+    if (m_files.empty())
+        return false;
+    for (size_t layer = 0; layer < m_files.size(); ++layer) {
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        SvtHeader header;
+        if (!file->open(m_files[layer]) || file->size() < sizeof(header)) {
+            std::cerr << "ERROR: cannot open virtual texture " << m_files[layer] << std::endl;
+            return false;
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion) {
+            std::cerr << "ERROR: " << m_files[layer] << " is not a virtual texture" << std::endl;
+            return false;
+        }
+        if (layer == 0) {
+            m_width = int(header.width);
+            m_height = int(header.height);
+            m_tileSize = int(header.tileSize);
+            m_border = int(header.border);
+            m_levels = int(header.levelCount);
+            m_tilesX = m_width / m_tileSize;
+            m_tilesY = m_height / m_tileSize;
+            m_levelStart.assign(1, 0);
+            for (int l = 0; l < m_levels; ++l)
+                m_levelStart.push_back(m_levelStart.back() + levelTilesX(l) * levelTilesY(l));
+            m_tilesPerLayer = m_levelStart.back();
+        } else if (int(header.width) != m_width || int(header.height) != m_height
+                   || int(header.tileSize) != m_tileSize || int(header.border) != m_border) {
+            std::cerr << "ERROR: " << m_files[layer] << " differs from the other virtual textures" << std::endl;
+            return false;
+        }
+        const size_t base = align16(sizeof(header));
+        if (file->size() < base + size_t(m_tilesPerLayer) * tileBytes()) {
+            std::cerr << "ERROR: truncated virtual texture " << m_files[layer] << std::endl;
+            return false;
+        }
+        m_tileBase.push_back(file->data() + base);
+        m_mapped.push_back(std::move(file));
+    }
+    const int layers = int(m_files.size());
+    if (m_atlasSlots * m_atlasSlots <= layers) {
+        std::cerr << "ERROR: the tile atlas cannot even hold the root tiles" << std::endl;
+        return false;
+    }
+
+    m_slots.assign(size_t(m_atlasSlots) * m_atlasSlots, Slot());
+    m_state.assign(size_t(layers) * m_tilesPerLayer, kAbsent);
+    m_slotOf.assign(m_state.size(), -1);
+    m_seen.assign(m_state.size(), 0);
+    m_entries.assign(m_state.size(), 0);
+
+    // table des pages : un niveau de mipmap par niveau de tuiles, lue par texelFetch
+    glGenTextures(1, &m_pageTable);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_pageTable);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_levels - 1);
+    for (int l = 0; l < m_levels; ++l) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, l, GL_RGBA8, levelTilesX(l), levelTilesY(l), layers, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // atlas : tuiles bordées côte à côte, filtrage bilinéaire sans mipmaps
+    const int atlasSize = m_atlasSlots * (m_tileSize + 2 * m_border);
+    glGenTextures(1, &m_atlas);
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, atlasSize, atlasSize, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+
+    // les racines, seules garanties résidentes, sont chargées tout de suite
+    for (int layer = 0; layer < layers; ++layer) {
+        const int root = tileIndex(layer, m_levels - 1, 0, 0);
+        m_slots[layer].pinned = true;
+        m_slots[layer].tile = root;
+        m_slotOf[root] = layer;
+        upload(root, tileData(root));
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    rebuildPageTable();
+
+    m_loader = std::thread(&VirtualTexture::loaderLoop, this);
+    return true;
+}
+
+void VirtualTexture::upload(int tile, const unsigned char *texels) {
+    const int slot = m_slotOf[tile];
+    const int padded = m_tileSize + 2 * m_border;
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % m_atlasSlots) * padded, (slot / m_atlasSlots) * padded,
+                    padded, padded, GL_RGB, GL_UNSIGNED_BYTE, texels);
+    m_state[tile] = kResident;
+    m_slots[slot].lastUsed = m_frame;
+    ++m_residentTiles;
+    m_pageTableDirty = true;
+}
+
+// Chaque entrée pointe vers la tuile résidente la plus fine qui couvre la
+// sienne : elle-même, sinon l'entrée de sa tuile parente (déjà calculée).
+void VirtualTexture::rebuildPageTable() {
+    const int layers = int(m_files.size());
+    std::vector<uint32_t> level;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_pageTable);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (int l = m_levels - 1; l >= 0; --l) {
+        const int tilesX = levelTilesX(l), tilesY = levelTilesY(l);
+        level.resize(size_t(layers) * tilesX * tilesY);
+        for (int layer = 0; layer < layers; ++layer) {
+            for (int y = 0; y < tilesY; ++y) {
+                for (int x = 0; x < tilesX; ++x) {
+                    const int tile = tileIndex(layer, l, x, y);
+                    uint32_t entry;
+                    if (m_state[tile] == kResident) {
+                        const int slot = m_slotOf[tile];
+                        // octets r, g, b, a : emplacement x, y dans l'atlas, niveau de la tuile
+                        entry = uint32_t(slot % m_atlasSlots) | uint32_t(slot / m_atlasSlots) << 8
+                              | uint32_t(l) << 16 | 0xff000000u;
+                    } else {
+                        entry = m_entries[tileIndex(layer, l + 1, std::min(x / 2, levelTilesX(l + 1) - 1),
+                                                    std::min(y / 2, levelTilesY(l + 1) - 1))];
+                    }
+                    m_entries[tile] = entry;
+                    level[(size_t(layer) * tilesY + y) * tilesX + x] = entry;
+                }
+            }
+        }
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, l, 0, 0, 0, tilesX, tilesY, layers, GL_RGBA, GL_UNSIGNED_BYTE, level.data());
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    m_pageTableDirty = false;
+}
+
+// Note la tuile et ses ancêtres : résidents, ils sont rafraîchis dans le
+// LRU ; absents, ils sont demandés (les ancêtres servent en attendant).
+void VirtualTexture::request(int layer, int level, int x, int y, std::vector<int> &seen) {
+    for (; level < m_levels; ++level, x /= 2, y /= 2) {
+        const int tile = tileIndex(layer, level, std::min(x, levelTilesX(level) - 1), std::min(y, levelTilesY(level) - 1));
+        if (m_seen[tile])
+            return;  // ancêtres déjà traités
+        m_seen[tile] = 1;
+        seen.push_back(tile);
+        if (m_state[tile] == kResident)
+            m_slots[m_slotOf[tile]].lastUsed = m_frame;
+    }
+}
+
+void VirtualTexture::update(size_t maxUploads) {
+    ++m_frame;
+    m_uploadsLastFrame = 0;
+
+    // --- Retour rendu il y a deux images : pas d'attente du GPU ---
+    const int read = m_feedbackIndex;
+    if (m_feedbackPending[read]) {
+        m_feedbackPending[read] = false;
+        // les demandes encore en file sont remplacées par celles-ci
+        {
+            std::lock_guard<std::mutex> lock(m_loadMutex);
+            for (size_t i = 0; i < m_loadQueue.size(); ++i)
+                m_state[m_loadQueue[i]] = kAbsent;
+            m_loadQueue.clear();
+        }
+
+        const size_t pixels = size_t(m_feedbackSize[read][0]) * m_feedbackSize[read][1];
+        std::vector<int> seen;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPbo[read]);
+        const GLushort *feedback = static_cast<const GLushort *>(
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(pixels * 4 * sizeof(GLushort)), GL_MAP_READ_BIT));
+        if (feedback) {
+            for (size_t p = 0; p < pixels; ++p) {
+                const GLushort *texel = feedback + 4 * p;
+                const int layer = int(texel[3]) - 1, level = texel[2];
+                if (layer < 0 || layer >= int(m_files.size()) || level >= m_levels)
+                    continue;  // fond, objet sans texture virtuelle
+                request(layer, level, texel[0], texel[1], seen);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // niveaux grossiers d'abord : ils couvrent le plus de surface
+        std::vector<std::pair<int, int>> wanted;  // (niveau, tuile)
+        for (size_t i = 0; i < seen.size(); ++i) {
+            m_seen[seen[i]] = 0;
+            if (m_state[seen[i]] == kAbsent) {
+                const int inLayer = seen[i] % m_tilesPerLayer;
+                const int level = int(std::upper_bound(m_levelStart.begin(), m_levelStart.end(), inLayer) - m_levelStart.begin()) - 1;
+                wanted.push_back(std::make_pair(level, seen[i]));
+            }
+        }
+        std::sort(wanted.begin(), wanted.end(), std::greater<std::pair<int, int>>());
+        {
+            std::lock_guard<std::mutex> lock(m_loadMutex);
+            for (size_t i = 0; i < wanted.size(); ++i) {
+                m_state[wanted[i].second] = kQueued;
+                m_loadQueue.push_back(wanted[i].second);
+            }
+        }
+        m_loadWake.notify_one();
+        m_requestedLastFrame = wanted.size();
+    }
+
+    // --- Envoi des tuiles lues ---
+    std::vector<LoadedTile> loaded;
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        const size_t n = std::min(maxUploads, m_loaded.size());
+        loaded.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            loaded.push_back(std::move(m_loaded[i]));
+        m_loaded.erase(m_loaded.begin(), m_loaded.begin() + n);
+    }
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        const int tile = loaded[i].tile;
+        // emplacement libre, sinon le moins récemment vu (O(emplacements), quelques centaines)
+        int victim = -1;
+        for (size_t s = 0; s < m_slots.size(); ++s) {
+            if (m_slots[s].pinned)
+                continue;
+            if (m_slots[s].tile < 0) {
+                victim = int(s);
+                break;
+            }
+            if (victim < 0 || m_slots[s].lastUsed < m_slots[victim].lastUsed)
+                victim = int(s);
+        }
+        if (victim < 0 || (m_slots[victim].tile >= 0 && m_slots[victim].lastUsed == m_frame)) {
+            m_state[tile] = kAbsent;  // atlas plein de tuiles visibles : on garde les plus grossières
+            continue;
+        }
+        Slot &slot = m_slots[victim];
+        if (slot.tile >= 0) {
+            m_state[slot.tile] = kAbsent;
+            m_slotOf[slot.tile] = -1;
+            --m_residentTiles;
+            ++m_evictions;
+        }
+        slot.tile = tile;
+        m_slotOf[tile] = victim;
+        upload(tile, loaded[i].texels.data());
+        ++m_uploadsLastFrame;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (m_pageTableDirty)
+        rebuildPageTable();
+}
+
+void VirtualTexture::loaderLoop() {
+    for (;;) {
+        int tile;
+        {
+            std::unique_lock<std::mutex> lock(m_loadMutex);
+            m_loadWake.wait(lock, [this]() { return m_stopping || !m_loadQueue.empty(); });
+            if (m_stopping)
+                return;
+            tile = m_loadQueue.front();
+            m_loadQueue.pop_front();
+        }
+        // la copie fait les lectures disque (défauts de page) hors du thread GL
+        LoadedTile loaded;
+        loaded.tile = tile;
+        const unsigned char *texels = tileData(tile);
+        loaded.texels.assign(texels, texels + tileBytes());
+
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        m_loaded.push_back(std::move(loaded));
+    }
+}
+
+void VirtualTexture::beginFeedback(int viewportWidth, int viewportHeight) {
+    const int width = std::max(1, viewportWidth / kFeedbackScale), height = std::max(1, viewportHeight / kFeedbackScale);
+    if (width != m_feedbackWidth || height != m_feedbackHeight) {
+        if (!m_feedbackFbo) {
+            glGenFramebuffers(1, &m_feedbackFbo);
+            glGenRenderbuffers(1, &m_feedbackColor);
+            glGenRenderbuffers(1, &m_feedbackDepth);
+            glGenBuffers(2, m_feedbackPbo);
+        }
+        glBindRenderbuffer(GL_RENDERBUFFER, m_feedbackColor);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA16UI, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_feedbackDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_feedbackFbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_feedbackColor);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_feedbackDepth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "WARNING: incomplete virtual texture feedback framebuffer" << std::endl;
+        m_feedbackWidth = width;
+        m_feedbackHeight = height;
+    }
+
+    glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_feedbackFbo);
+    glViewport(0, 0, width, height);
+    const GLuint none[4] = { 0, 0, 0, 0 };
+    glClearBufferuiv(GL_COLOR, 0, none);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void VirtualTexture::endFeedback() {
+    // lecture asynchrone dans un PBO, exploitée deux images plus tard par update()
+    const int write = m_feedbackIndex;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPbo[write]);
+    glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(size_t(m_feedbackWidth) * m_feedbackHeight * 4 * sizeof(GLushort)),
+                 nullptr, GL_STREAM_READ);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_feedbackWidth, m_feedbackHeight, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_feedbackSize[write][0] = m_feedbackWidth;
+    m_feedbackSize[write][1] = m_feedbackHeight;
+    m_feedbackPending[write] = true;
+    m_feedbackIndex ^= 1;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+}
+
+glm::vec3 VirtualTexture::shaderParams() const {
+    return glm::vec3(float(m_tileSize), float(m_border), float(m_levels - 1));
+}
+
+glm::vec3 VirtualTexture::feedbackParams() const {
+    return glm::vec3(float(m_tilesX), float(m_tilesY), std::log2(float(kFeedbackScale)));
+}
+
+size_t VirtualTexture::residentBytes() const {
+    return m_slots.size() * tileBytes() + m_entries.size() * sizeof(uint32_t);
+}
@@ -0,0 +1,140 @@
+#ifndef VIRTUALTEXTURE_H
+#define VIRTUALTEXTURE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include "MappedFile.h"
+
+// Fichier de tuiles (.svt) : une image de width x height texels (puissances
+// de deux, multiples de tileSize) et ses mipmaps, découpées en tuiles de
+// tileSize² texels entourées d'une bordure de border texels copiée des
+// voisines (filtrage bilinéaire sans couture dans l'atlas). Les niveaux
+// vont jusqu'à celui qui tient dans une seule tuile. Construit depuis une
+// image source, périmé dès que celle-ci change (comme TextureCache).
+// Construire une source de 32k demande de la décoder entière en mémoire :
+// c'est le rôle de textureCompressor --virtual, hors ligne.
+bool buildVirtualTextureFile(const std::string &source, const std::string &path,
+                             int width, int height, int tileSize = 128, int border = 4);
+// Le fichier existe, correspond à la source actuelle et a ces dimensions.
+bool virtualTextureFileIsCurrent(const std::string &source, const std::string &path,
+                                 int width, int height, int tileSize = 128, int border = 4);
+
+// Texturage virtuel : seules les tuiles vues sont chargées, dans un atlas
+// de taille fixe (atlasSlots² tuiles) géré en LRU. Une table des pages
+// (GL_TEXTURE_2D_ARRAY, une couche par texture virtuelle, un niveau de
+// mipmap par niveau de tuiles) donne pour chaque tuile l'emplacement dans
+// l'atlas de la tuile résidente la plus fine qui la couvre : elle-même ou
+// un ancêtre, la tuile du dernier niveau étant toujours résidente.
+//
+// Chaque image : update() lit le retour d'une image précédente (tuiles et
+// niveaux demandés par les fragments, rendus à basse résolution entre
+// beginFeedback() et endFeedback()), met en file les tuiles manquantes
+// pour le thread de chargement, envoie les tuiles lues et met à jour la
+// table des pages. La mémoire résidente ne dépend que de atlasSlots et de
+// la table des pages, pas de la taille des sources.
+class VirtualTexture
+{
+public:
+    explicit VirtualTexture(int atlasSlots = 16);
+    ~VirtualTexture();
+
+    // Toutes les couches partagent taille, tuiles et bordure.
+    int addLayer(const std::string &tiledFile);
+    // Thread GL : crée table des pages, atlas et cible du retour, charge
+    // les tuiles racines ; false si un fichier manque ou diffère des autres.
+    bool start();
+
+    // Thread GL, une fois par image, avant le rendu.
+    void update(size_t maxUploads);
+
+    // Rendu du retour : entre les deux appels, dessiner les objets avec un
+    // programme qui écrit uvec4(tuile x, tuile y, niveau, couche + 1).
+    void beginFeedback(int viewportWidth, int viewportHeight);
+    void endFeedback();
+
+    GLuint pageTable() const { return m_pageTable; }
+    GLuint atlas() const { return m_atlas; }
+    // Uniformes des shaders : x taille de tuile, y bordure, z dernier niveau.
+    glm::vec3 shaderParams() const;
+    // x, y : tuiles du niveau 0 ; z : biais de lod de la passe de retour.
+    glm::vec3 feedbackParams() const;
+
+    size_t residentTiles() const { return m_residentTiles; }
+    size_t slotCount() const { return m_slots.size(); }
+    size_t requestedLastFrame() const { return m_requestedLastFrame; }
+    size_t uploadsLastFrame() const { return m_uploadsLastFrame; }
+    size_t evictions() const { return m_evictions; }
+    size_t residentBytes() const;
+
+private:
+    // Une tuile est désignée par son indice global :
+    // couche * m_tilesPerLayer + m_levelStart[niveau] + y * tuilesX(niveau) + x.
+    enum TileState : unsigned char { kAbsent, kQueued, kResident };
+    struct Slot {
+        int tile = -1;
+        uint64_t lastUsed = 0;
+        bool pinned = false;  // tuile racine, jamais évincée
+    };
+    struct LoadedTile {
+        int tile;
+        std::vector<unsigned char> texels;
+    };
+
+    int levelTilesX(int level) const { return std::max(1, m_tilesX >> level); }
+    int levelTilesY(int level) const { return std::max(1, m_tilesY >> level); }
+    int tileIndex(int layer, int level, int x, int y) const;
+    const unsigned char *tileData(int tile) const;
+    size_t tileBytes() const;
+
+    void request(int layer, int level, int x, int y, std::vector<int> &seen);
+    void upload(int tile, const unsigned char *texels);
+    void rebuildPageTable();
+    void loaderLoop();
+
+    std::vector<std::string> m_files;
+    std::vector<std::unique_ptr<MappedFile>> m_mapped;
+    std::vector<const unsigned char *> m_tileBase;  // premier octet des tuiles de chaque couche
+    int m_width = 0, m_height = 0, m_tileSize = 0, m_border = 0, m_levels = 0;
+    int m_tilesX = 0, m_tilesY = 0;
+    std::vector<int> m_levelStart;
+    int m_tilesPerLayer = 0;
+
+    int m_atlasSlots;
+    std::vector<Slot> m_slots;
+    std::vector<unsigned char> m_state;  // TileState par tuile
+    std::vector<int> m_slotOf;           // emplacement d'une tuile résidente
+    std::vector<unsigned char> m_seen;   // tuiles déjà demandées cette image
+    std::vector<uint32_t> m_entries;     // table des pages côté CPU, tous niveaux
+    bool m_pageTableDirty = false;
+    uint64_t m_frame = 0;
+    size_t m_residentTiles = 0, m_requestedLastFrame = 0, m_uploadsLastFrame = 0, m_evictions = 0;
+
+    GLuint m_pageTable = 0, m_atlas = 0;
+    GLuint m_feedbackFbo = 0, m_feedbackColor = 0, m_feedbackDepth = 0;
+    GLuint m_feedbackPbo[2] = { 0, 0 };
+    bool m_feedbackPending[2] = { false, false };
+    int m_feedbackWidth = 0, m_feedbackHeight = 0;
+    int m_feedbackSize[2][2] = { { 0, 0 }, { 0, 0 } };
+    int m_feedbackIndex = 0;
+    GLint m_savedViewport[4] = { 0, 0, 0, 0 };
+
+    // Thread de chargement : lit les tuiles demandées dans les fichiers projetés.
+    std::thread m_loader;
+    std::mutex m_loadMutex;
+    std::condition_variable m_loadWake;
+    std::deque<int> m_loadQueue;          // niveaux grossiers d'abord
+    std::vector<LoadedTile> m_loaded;
+    bool m_stopping = false;
+};
+
+#endif // VIRTUALTEXTURE_H
@@ -0,0 +1,40 @@
+// Asset packer: bundles shaders, textures and meshes into the single archive that
+// tpOpenGL maps at start-up (see AssetArchive.h).
+// Usage: assetPacker [--lz4] output.pak root file...   (files are read from root and
+// stored under their path relative to it, e.g. media/earth.jpg)
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+
+int main(int argc, char **argv) {
+    bool lz4 = false;
+    int arg = 1;
+    if (arg < argc && std::string(argv[arg]) == "--lz4") {
+        lz4 = true;
+        ++arg;
+    }
+    if (argc - arg < 3) {
+        std::fprintf(stderr, "usage: %s [--lz4] output.pak root file...\n", argv[0]);
+        return 1;
+    }
+    const std::string output = argv[arg++];
+    const std::string root = argv[arg++];
+
+    std::vector<AssetSource> sources;
+    for (; arg < argc; ++arg) {
+        AssetSource source;
+        source.name = argv[arg];
+        source.file = root + "/" + source.name;
+        sources.push_back(source);
+    }
+
+    size_t original = 0, stored = 0;
+    if (!writeAssetArchive(output, sources, lz4, original, stored))
+        return 1;
+    std::printf("%s: %zu assets, %zu KiB -> %zu KiB%s\n", output.c_str(), sources.size(),
+                original / 1024, stored / 1024, lz4 ? " (lz4)" : "");
+    return 0;
+}
@@ -0,0 +1,287 @@
+// Micro-benchmarks of the CPU-side simulation kernels (no OpenGL context needed).
+// Usage: solarBench (build with CMAKE_BUILD_TYPE=Release for meaningful numbers)
+
+#define _USE_MATH_DEFINES
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "planet.h"
+#include "OrbitKernel.h"
+#include "Kepler.h"
+#include "NBody.h"
+#include "JobSystem.h"
+#include "Frustum.h"
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+static float randf(float lo, float hi) {
+    return lo + (hi - lo) * float(std::rand()) / float(RAND_MAX);
+}
+
+// Un système aléatoire : des planètes autour de l'origine, un corps sur huit est un satellite.
+static void fillSystem(Planet &system, size_t n) {
+    std::srand(42);
+    int lastPlanet = -1;
+    for (size_t i = 0; i < n; ++i) {
+        const bool moon = lastPlanet >= 0 && i % 8 == 7;
+        const int id = system.add(moon ? lastPlanet : -1, randf(0.05f, 1.f),
+                                  moon ? randf(0.5f, 2.f) : randf(2.f, 40.f),
+                                  randf(0.2f, 30.f), randf(0.f, 360.f), randf(0.f, 180.f),
+                                  randf(-3.f, 3.f), 0);
+        if (!moon)
+            lastPlanet = id;
+        system.setOrbitElements(id, randf(0.f, 0.9f), randf(0.f, 30.f), randf(0.f, 360.f), randf(0.f, 360.f));
+    }
+}
+
+template<typename F>
+static double nsPerBody(size_t n, F step) {
+    const size_t iterations = std::max<size_t>(3, 20000000 / n);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        step(double(it) * 0.016);
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / double(iterations * n);
+}
+
+static void benchOrbitKernel() {
+    std::printf("Orbital model matrices (kernel width %zu)\n", orbitKernelWidth());
+    std::printf("%10s %14s %14s %9s %12s\n", "bodies", "scalar ns/body", "kernel ns/body", "speedup", "max error");
+
+    const size_t counts[] = { 10, 10000, 1000000 };
+    for (size_t n : counts) {
+        Planet system;
+        fillSystem(system, n);
+
+        const double scalar = nsPerBody(n, [&](double t) { system.updateReference(t); });
+        const double kernel = nsPerBody(n, [&](double t) { system.update(t); });
+
+        // écart entre les deux chemins à un instant quelconque
+        const double t = 123.4;
+        system.updateReference(t);
+        const std::vector<glm::mat4> reference = system.models();
+        system.update(t);
+        float maxError = 0.f;
+        for (size_t i = 0; i < n; ++i)
+            for (int c = 0; c < 4; ++c)
+                for (int r = 0; r < 4; ++r)
+                    maxError = std::max(maxError, std::fabs(reference[i][c][r] - system.model(i)[c][r]));
+
+        std::printf("%10zu %14.2f %14.2f %8.2fx %12.2e\n", n, scalar, kernel, scalar / kernel, maxError);
+    }
+}
+
+// Résout E - e sin E = M en double, par bisection : référence de précision.
+static double keplerBisection(double M, double e) {
+    M = M - 2.0 * M_PI * std::floor(M / (2.0 * M_PI) + 0.5);
+    double lo = -M_PI, hi = M_PI;
+    for (int k = 0; k < 100; ++k) {
+        const double mid = 0.5 * (lo + hi);
+        if (mid - e * std::sin(mid) < M) lo = mid; else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+static void benchKepler() {
+    std::printf("\nKepler propagation (%d Newton iterations, kernel width %zu)\n", kKeplerIterations, orbitKernelWidth());
+
+    // précision du solveur vectoriel, par tranche d'excentricité
+    const size_t samples = 4096;
+    std::vector<float> zero(samples, 0.f), one(samples, 1.f);
+    std::vector<float> e(samples), M(samples), cosE(samples), sinE(samples), unused(samples);
+    const float eMax[] = { 0.1f, 0.5f, 0.8f, 0.9f, 0.97f };
+    for (float em : eMax) {
+        for (size_t i = 0; i < samples; ++i) {
+            e[i] = em;
+            M[i] = -3.14159f + 6.28318f * float(i) / float(samples);
+        }
+        // px = 1, qy = 1 : x = cos E - e, y = sin E
+        const KeplerBatch in = { e.data(), zero.data(), M.data(), one.data(), zero.data(), zero.data(),
+                                 zero.data(), one.data(), zero.data() };
+        propagateKepler(samples, 0.f, in, cosE.data(), sinE.data(), unused.data());
+        double maxError = 0.0;
+        for (size_t i = 0; i < samples; ++i) {
+            const double E = keplerBisection(M[i], em);
+            maxError = std::max(maxError, std::fabs(double(cosE[i] + em) - std::cos(E)));
+            maxError = std::max(maxError, std::fabs(double(sinE[i]) - std::sin(E)));
+        }
+        std::printf("  e = %.2f : max position error %.2e (unit semi-major axis)\n", em, maxError);
+    }
+
+    // le coût ne dépend pas de l'écart en temps
+    const size_t n = 100000;
+    Planet system;
+    fillSystem(system, n);
+    const double jumps[] = { 1.0, 1000.0, 1000000.0 };
+    for (double jump : jumps) {
+        const double ns = nsPerBody(n, [&](double t) { system.update(jump + t); });
+        std::printf("  t = %9.0f : %.2f ns/body (propagation + matrices)\n", jump, ns);
+    }
+}
+
+// Un disque d'astéroïdes autour d'un Soleil de masse 100, vitesses circulaires.
+static void fillAsteroidBelt(NBody &field, size_t n) {
+    std::srand(7);
+    const float sunMass = 100.f;
+    for (size_t i = 0; i < n; ++i) {
+        const float r = randf(9.5f, 10.5f), a = randf(0.f, 6.2831853f);
+        const glm::vec3 p(r * std::cos(a), randf(-0.2f, 0.2f), -r * std::sin(a));
+        const float v = std::sqrt(sunMass / r);
+        field.add(p, glm::vec3(-v * std::sin(a), 0.f, -v * std::cos(a)), 1e-4f);
+    }
+    field.setAttractors(std::vector<glm::vec3>(1, glm::vec3(0.f)), std::vector<float>(1, sunMass));
+}
+
+template<typename F>
+static double secondsFor(F f) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Sphères aléatoires autour de la caméra : environ un sixième dans le champ.
+static void benchCulling() {
+    const glm::mat4 proj = glm::perspective(glm::radians(45.f), 16.f / 9.f, 0.1f, 100.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.f, 5.f, 30.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    const Frustum frustum(proj * view);
+
+    std::printf("\nFrustum culling of bounding spheres\n");
+    std::printf("%10s %16s %16s %10s %10s\n", "spheres", "scalar ns/body", "kernel ns/body", "speedup", "visible");
+    const size_t counts[] = { 1000, 100000, 1000000 };
+    for (size_t n : counts) {
+        std::srand(7);
+        std::vector<float> x(n), y(n), z(n), r(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = randf(-60.f, 60.f); y[i] = randf(-60.f, 60.f); z[i] = randf(-60.f, 60.f);
+            r[i] = randf(0.01f, 1.f);
+        }
+        std::vector<unsigned char> scalar(n), kernel(n);
+        const int reps = int(std::max<size_t>(1, 2000000 / n));
+        const double ts = secondsFor([&]() {
+            for (int k = 0; k < reps; ++k)
+                for (size_t i = 0; i < n; ++i)
+                    scalar[i] = frustum.intersectsSphere(glm::vec3(x[i], y[i], z[i]), r[i]) ? 1 : 0;
+        });
+        const double tk = secondsFor([&]() {
+            for (int k = 0; k < reps; ++k)
+                cullSpheres(frustum, n, x.data(), y.data(), z.data(), r.data(), kernel.data());
+        });
+        size_t visible = 0, mismatches = 0;
+        for (size_t i = 0; i < n; ++i) {
+            visible += kernel[i];
+            mismatches += scalar[i] != kernel[i];
+        }
+        const double ns = 1e9 / double(n * reps);
+        std::printf("%10zu %16.2f %16.2f %9.2fx %10zu%s\n", n, ts * ns, tk * ns, ts / tk, visible,
+                    mismatches ? " MISMATCH" : "");
+    }
+}
+
+// Sommets et triangles nécessaires à chaque générateur pour un même écart
+// à la sphère (plus petite résolution qui l'atteint).
+static void benchSphereMeshes() {
+    std::printf("\nSphere generators at equal geometric error (unit sphere)\n");
+    std::printf("%10s %24s %24s %24s\n", "max error", "UV sphere (res) v / t", "icosphere (subdiv) v / t", "cube sphere (div) v / t");
+    const float targets[] = { 1e-2f, 1e-3f, 1e-4f };
+    for (float target : targets) {
+        std::shared_ptr<Mesh> uv, ico, cube;
+        size_t res = 4, subdiv = 0, div = 1;
+        for (;; res += 2) { uv = Mesh::genSphere(res); if (uv->sphereError() <= target) break; }
+        for (;; ++subdiv) { ico = Mesh::genIcosphere(subdiv); if (ico->sphereError() <= target) break; }
+        for (;; ++div) { cube = Mesh::genCubeSphere(div); if (cube->sphereError() <= target) break; }
+
+        char col[3][32];
+        std::snprintf(col[0], sizeof(col[0]), "(%zu) %zu / %zu", res, uv->vertexCount(), uv->triangleCount());
+        std::snprintf(col[1], sizeof(col[1]), "(%zu) %zu / %zu", subdiv, ico->vertexCount(), ico->triangleCount());
+        std::snprintf(col[2], sizeof(col[2]), "(%zu) %zu / %zu", div, cube->vertexCount(), cube->triangleCount());
+        std::printf("%10.0e %24s %24s %24s\n", target, col[0], col[1], col[2]);
+    }
+}
+
+// Ordre des triangles avant et après Mesh::optimize (cache FIFO de 16 sommets).
+static void benchMeshOptimizer() {
+    std::printf("\nVertex cache optimization (FIFO %zu)\n", kVertexCacheSize);
+    std::printf("%18s %10s %14s %14s %9s %12s\n", "mesh", "triangles", "ACMR", "ATVR", "clusters", "time ms");
+    struct Case { const char *name; std::shared_ptr<Mesh> mesh; };
+    Case cases[] = {
+        { "UV sphere 32", Mesh::genSphere(32) },
+        { "UV sphere 128", Mesh::genSphere(128) },
+        { "icosphere 5", Mesh::genIcosphere(5) },
+        { "cube sphere 64", Mesh::genCubeSphere(64) },
+    };
+    for (Case &c : cases) {
+        Mesh::CacheStats stats;
+        const double seconds = secondsFor([&]() { stats = c.mesh->optimize(); });
+        char acmr[32], atvr[32];
+        std::snprintf(acmr, sizeof(acmr), "%.3f -> %.3f", stats.acmrBefore, stats.acmrAfter);
+        std::snprintf(atvr, sizeof(atvr), "%.3f -> %.3f", stats.atvrBefore, stats.atvrAfter);
+        std::printf("%18s %10zu %14s %14s %9zu %12.2f\n", c.name, c.mesh->triangleCount(), acmr, atvr,
+                    stats.overdrawClusters, seconds * 1e3);
+    }
+}
+
+// Charge des threads de l'ordonnanceur pendant les mesures précédentes.
+static void printJobStats() {
+    const std::vector<JobSystem::WorkerStats> stats = JobSystem::shared().stats();
+    std::printf("\nJob system (%u workers + calling threads)\n", JobSystem::shared().workerCount());
+    std::printf("%10s %10s %10s %10s %10s\n", "worker", "busy s", "idle s", "jobs", "steals");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        char name[24];
+        if (i + 1 < stats.size())
+            std::snprintf(name, sizeof(name), "%zu", i);
+        else
+            std::snprintf(name, sizeof(name), "callers");
+        std::printf("%10s %10.3f %10.3f %10llu %10llu\n", name, stats[i].busySeconds, stats[i].idleSeconds,
+                    (unsigned long long)stats[i].jobs, (unsigned long long)stats[i].steals);
+    }
+}
+
+static void benchNBody() {
+    std::printf("\nBarnes-Hut vs brute force (theta 0.5, %u threads)\n", JobSystem::shared().workerCount() + 1);
+    std::printf("%10s %12s %12s %10s %16s\n", "bodies", "BH steps/s", "N^2 steps/s", "nodes", "rms force error");
+
+    const size_t counts[] = { 1000, 10000, 100000, 1000000 };
+    for (size_t n : counts) {
+        NBody field;
+        fillAsteroidBelt(field, n);
+        // sans les attracteurs, pour mesurer l'erreur des seules forces mutuelles
+        field.setAttractors(std::vector<glm::vec3>(), std::vector<float>());
+
+        const int steps = n >= 1000000 ? 1 : 5;
+        const double bh = steps / secondsFor([&]() { for (int s = 0; s < steps; ++s) field.computeAccelerations(); });
+        std::vector<glm::vec3> tree(n);
+        for (size_t i = 0; i < n; ++i)
+            tree[i] = field.acceleration(i);
+
+        if (n > 10000) {
+            std::printf("%10zu %12.2f %12s %10zu %16s\n", n, bh, "-", field.nodeCount(), "-");
+            continue;
+        }
+        const double direct = 1.0 / secondsFor([&]() { field.computeAccelerations(true); });
+        double err2 = 0.0, ref2 = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const glm::vec3 d = tree[i] - field.acceleration(i);
+            err2 += glm::dot(d, d);
+            ref2 += glm::dot(field.acceleration(i), field.acceleration(i));
+        }
+        std::printf("%10zu %12.2f %12.2f %10zu %16.2e\n", n, bh, direct, field.nodeCount(), std::sqrt(err2 / ref2));
+    }
+}
+
+int main() {
+    benchOrbitKernel();
+    benchKepler();
+    benchNBody();
+    benchCulling();
+    benchSphereMeshes();
+    benchMeshOptimizer();
+    printJobStats();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,29 @@
+# ----------------------------------------------------------------------------
+# embedShaders.cmake
+#
+# Copies the GLSL sources into a C++ file, so that tpOpenGL reads no shader
+# file at startup (see ShaderVariants.h). Run by the build:
+#   cmake -DOUTPUT=EmbeddedShaders.cpp -DSOURCE_DIR=src -DSHADERS=a.glsl,b.glsl -P embedShaders.cmake
+# ----------------------------------------------------------------------------
+
+string(REPLACE "," ";" SHADERS "${SHADERS}")
+set(content "// Generated by embedShaders.cmake from the GLSL sources, do not edit.\n\n#include \"ShaderVariants.h\"\n\n")
+set(table "")
+set(index 0)
+foreach(shader ${SHADERS})
+  file(READ ${SOURCE_DIR}/${shader} hex HEX)
+  string(LENGTH "${hex}" digits)
+  math(EXPR length "${digits} / 2")
+  # Bytes rather than a string literal: no escaping, no compiler limit on literal length
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+  string(REGEX REPLACE "(0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,)" "\\1\n    " bytes "${bytes}")
+  string(APPEND content "static const unsigned char kSource${index}[] = {\n    ${bytes}0x00 };\n\n")
+  string(APPEND table "    { \"${shader}\", kSource${index}, ${length} },\n")
+  math(EXPR index "${index} + 1")
+endforeach()
+string(APPEND content "const EmbeddedShader kEmbeddedShaders[] = {\n${table}};\nconst size_t kEmbeddedShaderCount = ${index};\n")
+
+# Rewritten only when it changes, to keep the dependent objects up to date
+file(WRITE ${OUTPUT}.tmp "${content}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
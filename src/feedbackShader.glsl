@@ -0,0 +1,31 @@
+#version 330 core            // Minimal GL version support expected from the GPU
+
+// Passe de retour du texturage virtuel (voir VirtualTexture.h) : rendue a
+// basse resolution, chaque fragment ecrit la tuile et le niveau que le
+// rendu normal lirait. Meme choix de niveau que virtualAlbedo().
+
+uniform vec3 virtualParams;  // x : taille d'une tuile, y : bordure, z : dernier niveau
+uniform vec3 feedbackParams; // xy : tuiles du niveau 0, z : log2 du facteur de reduction
+
+in vec2 fTexCoords;
+flat in float fVirtual;
+
+out uvec4 feedback;
+
+void main()
+{
+    if (fVirtual < 0.0) {
+        feedback = uvec4(0u); // occultant, mais sans texture virtuelle
+        return;
+    }
+    vec2 uv = vec2(fract(fTexCoords.x), clamp(fTexCoords.y, 0.0, 1.0));
+    vec2 size = feedbackParams.xy * virtualParams.x;
+    vec2 dx = dFdx(fTexCoords * size), dy = dFdy(fTexCoords * size);
+    // les derivees sont plus grandes du facteur de reduction qu'a pleine resolution
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) - feedbackParams.z;
+    int level = int(clamp(floor(lod), 0.0, virtualParams.z));
+
+    ivec2 tiles = max(ivec2(feedbackParams.xy) >> level, ivec2(1));
+    ivec2 tile = min(ivec2(uv * vec2(tiles)), tiles - 1);
+    feedback = uvec4(uvec2(tile), uint(level), uint(fVirtual) + 1u);
+}
@@ -87,61 +87,104 @@
 // }
 
 
+// Variantes (ShaderVariants.h), definies avant la compilation : EMISSIVE,
+// LIT, TEXTURED, VIRTUAL_TEXTURE et QUALITY (0 : sans speculaire).
+#ifndef QUALITY
+#define QUALITY 1
+#endif
+
 uniform vec3 camPos;
-uniform int isLightSource;
-uniform vec3 objectColor;
-uniform vec3 lightPos;
+uniform vec3 objectColor; // couleur des variantes sans texture
+uniform vec3 lightPos;    // position du Soleil dans le monde
 
 struct Material {
-    sampler2D albedoTex;
+    sampler2DArray albedoTex; // une couche par planete
+    sampler2DArray pageTable; // textures virtuelles : tuile residente de chaque tuile
+    sampler2D tileCache;      // atlas des tuiles residentes
 };
 
 uniform Material material;
+uniform vec3 virtualParams; // x : taille d'une tuile, y : bordure, z : dernier niveau
 
 in vec3 fPosition;
 in vec3 fNormal;
 in vec2 fTexCoords;
+flat in float fLayer;
+flat in float fMinLod;
+flat in float fVirtual;
 
 out vec4 color;
-void main()
+
+#ifdef VIRTUAL_TEXTURE
+// Texture virtuelle : la table des pages, au niveau voulu, donne la tuile
+// residente la plus fine (elle-meme ou un ancetre) et sa place dans
+// l'atlas. Filtrage bilineaire dans la tuile, grace a sa bordure.
+vec4 virtualAlbedo()
+{
+    float tileSize = virtualParams.x;
+    vec2 uv = vec2(fract(fTexCoords.x), clamp(fTexCoords.y, 0.0, 1.0));
+    vec2 size = vec2(textureSize(material.pageTable, 0).xy) * tileSize;
+    vec2 dx = dFdx(fTexCoords * size), dy = dFdy(fTexCoords * size);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+    int level = int(clamp(floor(lod), 0.0, virtualParams.z));
+
+    ivec2 tiles = textureSize(material.pageTable, level).xy;
+    ivec2 tile = min(ivec2(uv * vec2(tiles)), tiles - 1);
+    vec3 entry = floor(texelFetch(material.pageTable, ivec3(tile, int(fVirtual)), level).xyz * 255.0 + 0.5);
+
+    // entry.z : niveau de la tuile effectivement residente
+    vec2 residentTiles = vec2(textureSize(material.pageTable, int(entry.z)).xy);
+    vec2 levelSize = max(size / exp2(entry.z), vec2(1.0));
+    vec2 inTile = uv * levelSize - min(floor(uv * residentTiles), residentTiles - 1.0) * tileSize;
+    vec2 texel = entry.xy * (tileSize + 2.0 * virtualParams.y) + virtualParams.y + inTile;
+    return textureLod(material.tileCache, texel / vec2(textureSize(material.tileCache, 0)), 0.0);
+}
+#endif
+
+// Couleur de base de la surface. Avec TEXTURED : equivalent de texture(),
+// mais sans descendre sous fMinLod, les niveaux plus fins de la couche ne
+// sont peut-etre pas encore charges.
+vec3 albedo()
 {
+#if defined(VIRTUAL_TEXTURE)
+    return virtualAlbedo().rgb;
+#elif defined(TEXTURED)
+    vec2 texels = fTexCoords * vec2(textureSize(material.albedoTex, 0).xy);
+    vec2 dx = dFdx(texels), dy = dFdy(texels);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+    return textureLod(material.albedoTex, vec3(fTexCoords, fLayer), max(lod, fMinLod)).rgb;
+#else
+    return objectColor;
+#endif
+}
 
+void main()
+{
+#if defined(LIT) && !defined(EMISSIVE)
     float ka = 0.3;   // ambient
     float kd = 1.0;   // diffuse
-    float ks = 0.6;   // specular
-    float alpha = 64.0; // brillance
     vec3 lightColor = vec3(1.0);
-    vec3 lightPos   = vec3(0.0, 0.0, 0.0); // soleil = lumière au centre
-
-
-    if (isLightSource == 1) {
-        color = vec4(objectColor, 1.0);
-        color=texture(material.albedoTex, fTexCoords);
-        return;
-    }
-
 
     vec3 n = normalize(fNormal);
     vec3 l = normalize(lightPos - fPosition);
-    vec3 v = normalize(camPos - fPosition);
-    vec3 r = reflect(-l, n);
-
-
-    vec3 ambient  = ka * lightColor ;
-       float diff = max(dot(n, l), 0.0);
-       vec3 diffuse  = kd * diff * lightColor ;
-       float spec = pow(max(dot(v, r), 0.0), alpha);
-       vec3 specular = ks * spec * lightColor;
-
 
-    //color = texture(material.albedoTex, fTexCoords);
+    vec3 ambient = ka * lightColor;
+    float diff = max(dot(n, l), 0.0);
+    vec3 diffuse = kd * diff * lightColor;
 
-
-       // Récupération de la couleur de texture
-          vec3 texColor = texture(material.albedoTex, fTexCoords).rgb;
-
-          // Combinaison : texture * (ambiant + diffus) + spéculaire
-          vec3 finalColor = texColor * (ambient + diffuse) + specular;
-
-          color = vec4(finalColor, 1.0);
+    // Combinaison : texture * (ambiant + diffus) + speculaire
+    vec3 finalColor = albedo() * (ambient + diffuse);
+#if QUALITY > 0
+    float ks = 0.6;     // specular
+    float alpha = 64.0; // brillance
+    vec3 v = normalize(camPos - fPosition);
+    vec3 r = reflect(-l, n);
+    float spec = pow(max(dot(v, r), 0.0), alpha);
+    finalColor += ks * spec * lightColor;
+#endif
+    color = vec4(finalColor, 1.0);
+#else
+    // EMISSIVE, ou sans eclairage : la surface eclaire elle-meme
+    color = vec4(albedo(), 1.0);
+#endif
 }
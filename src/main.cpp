@@ -24,6 +24,10 @@
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -32,7 +36,25 @@
 #include <string>
 #include <cmath>
 #include <memory>
+#include <thread>
+#include "AssetArchive.h"
 #include "Mesh.h"
+#include "ProgramCache.h"
+#include "ShaderPipeline.h"
+#include "ShaderProgram.h"
+#include "ShaderVariants.h"
+#include "TextureArray.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+#include "VirtualTexture.h"
+#include "planet.h"
+#include "NBody.h"
+#include "JobSystem.h"
+#include "Frustum.h"
+#include "Lod.h"
+#include "SimClock.h"
+#include "Timeline.h"
+#include "TripleBuffer.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -42,15 +64,48 @@
 GLFWwindow *g_window = nullptr;
 
 // GPU objects
-GLuint g_program = 0; // A GPU program contains at least a vertex shader and a fragment shader
+std::unique_ptr<ProgramCache> g_programCache; // Linked binaries from earlier runs (--no-program-cache)
+bool g_useProgramCache = true;
+std::unique_ptr<ShaderPipeline> g_shaderPipeline; // Programs compile in the driver until each one is first needed
+Timeline g_timeline; // Startup stages, from process start
+bool g_programsReported = false;
+bool g_firstFramePresented = false;
+
+// One GPU program per fragment shader variant used by the bodies (see ShaderVariants.h), submitted at startup
+struct BodyProgram {
+  ShaderVariant variant;
+  GLuint program = 0; // A GPU program contains at least a vertex shader and a fragment shader
+  std::shared_ptr<ShaderProgram> shader; // Reflected view of program, null until first drawn with (finishBodyProgram())
+  // Uniform handles resolved once after linking
+  ShaderProgram::Uniform viewMat, projMat, camPos, lightPos, albedoTex, tileCache, pageTable, virtualParams;
+  std::vector<std::vector<Mesh::InstanceData>> instances; // Per sphere LOD, refilled every frame
+  std::vector<size_t> firstInstance; // Per sphere LOD, offset of instances in g_lodInstances
+};
+std::vector<std::unique_ptr<BodyProgram>> g_bodyPrograms;
+std::vector<BodyProgram*> g_planetProgram; // Variant of each planet, fixed once the scene is built
+BodyProgram *g_asteroidProgram = nullptr;
+// Instances of every variant, concatenated per sphere LOD and uploaded once per frame for both passes
+std::vector<std::vector<Mesh::InstanceData>> g_lodInstances;
+int g_shaderQuality = 1; // Shader tier of the planets (--shader-quality=0|1); asteroids always use 0
+
+// Feedback pass of the virtual textures: same vertex shader, writes the tiles each fragment needs
+GLuint g_feedbackProgram = 0;
+std::shared_ptr<ShaderProgram> g_feedbackShader;
+struct {
+  ShaderProgram::Uniform viewMat, projMat, virtualParams, feedbackParams;
+} g_feedbackUniforms;
+
+// Planet maps packed by assetPacker, mapped once; loose files are read when it is missing
+AssetArchive g_assets;
 
 // OpenGL identifiers
 GLuint g_vao = 0;
 GLuint g_posVbo = 0;
 GLuint g_colVbo = 0;
 GLuint g_ibo = 0;
-GLuint g_texSun=0, g_texEarth=0, g_texMoon=0, g_texMercure=0,
-    g_texVenus=0,g_texMars=0,g_texJupiter=0,g_texSaturne=0,g_texUranuss=0,g_texNeptune=0;
+GLuint g_texPlanets = 0; // All planet maps, one layer each, in a single GL_TEXTURE_2D_ARRAY
+int g_layerSun=0, g_layerEarth=0, g_layerMoon=0, g_layerMercure=0,
+    g_layerVenus=0, g_layerMars=0, g_layerJupiter=0;
 
 
 // All vertex positions packed in one array [x0, y0, z0, x1, y1, z1, ...]
@@ -60,6 +115,39 @@ std::vector<unsigned int> g_triangleIndices;
 std::vector<float> g_vertexColors;
 
 
+// Texture options (--mips=none|gpu|cpu, --no-stream, --no-compress)
+MipMode g_mipMode = MipMode::Gpu;
+bool g_streamTextures = true; // Background decoding and progressive upload; needs CPU mipmaps
+bool g_compressTextures = true; // BC1 when streaming, if the driver has S3TC (RGBA8 otherwise)
+double g_textureStart = 0.0; // When texture loading began, to time streaming
+const static size_t kTextureUploadBudget = 4 << 20; // Bytes sent to the GPU per frame while streaming
+std::unique_ptr<TextureCache> g_textureCache;
+std::unique_ptr<TextureStreamer> g_textureStreamer; // Null once every map is resident, or without streaming
+
+// Virtual texturing of the close-up maps (--no-virtual, --virtual-size=WxH)
+bool g_virtualTextures = true;
+int g_virtualWidth = 2048, g_virtualHeight = 1024; // Common size of the tiled maps, powers of two
+const static size_t kTileUploadsPerFrame = 8;
+std::unique_ptr<VirtualTexture> g_virtualTexture;
+std::vector<float> g_virtualLayerOf; // Virtual layer of each texture array layer, -1 if none
+
+// Frame statistics (printed with I)
+size_t g_visibleLastFrame = 0, g_bodiesLastFrame = 0, g_trianglesLastFrame = 0;
+int g_viewportWidth = 1, g_viewportHeight = 1; // In pixels, for projected body sizes and the feedback pass
+
+// Simulation options
+// Written by the GL thread (keyboard), read by the simulation thread
+const static double kWarpDefault = 0.7; // Simulation time units per real second
+std::atomic<bool> g_gravity(false); // Gravitational asteroid belt (toggled with G)
+std::atomic<bool> g_simPaused(false);
+std::atomic<double> g_simWarp(kWarpDefault);
+
+// Simulation thread: owns g_clock and the scene, publishes frames for the renderer
+SimClock g_clock(1.0 / 120.0); // Fixed simulation step, independent of the display rate
+std::thread g_simThread;
+std::atomic<bool> g_simRunning(false);
+TripleBuffer<SimFrame> g_frames;
+
 // Basic camera model
 class Camera {
 public:
@@ -93,31 +181,43 @@ private:
 Camera g_camera;
 
 
-GLuint loadTextureFromFileToGPU(const std::string &filename) {
-    int width, height, numComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &numComponents, 0);
-
-    GLuint texID;
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-
-    stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    return texID;
-}
-
-
 // Executed each time the window is resized. Adjust the aspect ratio and the rendering viewport to the current window.
 void windowSizeCallback(GLFWwindow* window, int width, int height) {
   g_camera.setAspectRatio(static_cast<float>(width)/static_cast<float>(height));
   glViewport(0, 0, (GLint)width, (GLint)height); // Dimension of the rendering region in the window
+  g_viewportWidth = std::max(width, 1);
+  g_viewportHeight = std::max(height, 1);
+}
+
+// Prints the counters gathered during the last rendered frame
+void printFrameStats() {
+  size_t uploads = 0, skipped = 0;
+  for(size_t p = 0; p < g_bodyPrograms.size(); ++p) {
+    if(!g_bodyPrograms[p]->shader)
+      continue;
+    uploads += g_bodyPrograms[p]->shader->uploadsLastFrame();
+    skipped += g_bodyPrograms[p]->shader->skippedLastFrame();
+  }
+  std::cout << "Uniform uploads: " << uploads << ", avoided: " << skipped
+            << " (" << g_bodyPrograms.size() << " shader variants)" << std::endl;
+  std::cout << "Visible bodies: " << g_visibleLastFrame << " / " << g_bodiesLastFrame
+            << ", triangles: " << g_trianglesLastFrame << std::endl;
+  if(g_virtualTexture)
+    std::cout << "Virtual textures: " << g_virtualTexture->residentTiles() << " / " << g_virtualTexture->slotCount()
+              << " tiles resident, " << g_virtualTexture->requestedLastFrame() << " requested and "
+              << g_virtualTexture->uploadsLastFrame() << " uploaded last frame, "
+              << g_virtualTexture->evictions() << " evictions" << std::endl;
+  if(g_textureStreamer)
+    std::cout << "Texture streaming: " << g_textureStreamer->bytesUploadedLastFrame() / 1024
+              << " KiB uploaded last frame" << std::endl;
+  // Job system load since the last print
+  const std::vector<JobSystem::WorkerStats> stats = JobSystem::shared().stats();
+  for(size_t i = 0; i < stats.size(); ++i) {
+    std::cout << (i + 1 < stats.size() ? "Worker " + std::to_string(i) : std::string("Callers"))
+              << ": busy " << stats[i].busySeconds << " s, idle " << stats[i].idleSeconds
+              << " s, " << stats[i].jobs << " jobs, " << stats[i].steals << " stolen" << std::endl;
+  }
+  JobSystem::shared().resetStats();
 }
 
 // Executed each time a key is entered.
@@ -126,6 +226,16 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
     glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
   } else if(action == GLFW_PRESS && key == GLFW_KEY_F) {
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+  } else if(action == GLFW_PRESS && key == GLFW_KEY_G) {
+    g_gravity = !g_gravity;
+  } else if(action == GLFW_PRESS && key == GLFW_KEY_P) {
+    g_simPaused = !g_simPaused;
+  } else if(action == GLFW_PRESS && (key == GLFW_KEY_EQUAL || key == GLFW_KEY_KP_ADD)) {
+    g_simWarp = g_simWarp * 2.0;
+  } else if(action == GLFW_PRESS && (key == GLFW_KEY_MINUS || key == GLFW_KEY_KP_SUBTRACT)) {
+    g_simWarp = g_simWarp * 0.5;
+  } else if(action == GLFW_PRESS && key == GLFW_KEY_I) {
+    printFrameStats();
   } else if(action == GLFW_PRESS && (key == GLFW_KEY_ESCAPE || key == GLFW_KEY_Q)) {
     glfwSetWindowShouldClose(window, true); // Closes the application if the escape key is pressed
   }
@@ -183,52 +293,169 @@ void initOpenGL() {
   glClearColor(0.0f, 0.0f, 0.4f, 1.0f); // specify the background color, used any time the framebuffer is cleared
 }
 
-// Loads the content of an ASCII file in a standard C++ string
-std::string file2String(const std::string &filename) {
-  std::ifstream t(filename.c_str());
-  std::stringstream buffer;
-  buffer << t.rdbuf();
-  return buffer.str();
+// Returns the program of a variant, submitting its compilation the first time it is asked for
+BodyProgram &bodyProgram(const ShaderVariant &variant) {
+  for(size_t p = 0; p < g_bodyPrograms.size(); ++p)
+    if(g_bodyPrograms[p]->variant == variant)
+      return *g_bodyPrograms[p];
+
+  std::unique_ptr<BodyProgram> body(new BodyProgram());
+  body->variant = variant;
+  body->program = g_shaderPipeline->submit(variant.name(), "vertexShader.glsl", "fragmentShader.glsl", shaderDefines(variant));
+  g_bodyPrograms.push_back(std::move(body));
+  return *g_bodyPrograms.back();
+}
+
+// Prints the program statistics once the last submitted program is ready
+void reportProgramsReady() {
+  if(g_programsReported || g_shaderPipeline->pending() > 0)
+    return;
+  g_programsReported = true;
+  std::ostringstream stage;
+  stage << "All programs ready, " << int(g_shaderPipeline->waitedMs()) << " ms blocked on the driver ("
+        << (g_shaderPipeline->parallel() ? "parallel" : "serial") << " compilation)";
+  if(g_programCache)
+    stage << ", program cache: " << g_programCache->hits() << "/" << g_programCache->hits() + g_programCache->misses()
+          << " hits, " << int(1000.0 * g_programCache->secondsSaved()) << " ms saved";
+  g_timeline.mark(stage.str());
+}
+
+// First draw with a body program: waits for its link if the driver is not done yet, then resolves its uniforms
+void finishBodyProgram(BodyProgram &body) {
+  g_shaderPipeline->finish(body.program);
+  body.shader = ShaderProgram::wrap(body.program);
+  body.viewMat = body.shader->uniform("viewMat");
+  body.projMat = body.shader->uniform("projMat");
+  body.camPos = body.shader->uniform("camPos");
+  body.lightPos = body.shader->uniform("lightPos");
+  body.albedoTex = body.shader->uniform("material.albedoTex");
+  body.tileCache = body.shader->uniform("material.tileCache");
+  body.pageTable = body.shader->uniform("material.pageTable");
+  body.virtualParams = body.shader->uniform("virtualParams");
+
+  body.shader->use();
+  body.shader->set(body.albedoTex, 0);
+  body.shader->set(body.tileCache, 1);
+  body.shader->set(body.pageTable, 2);
+  if(g_virtualTexture)
+    body.shader->set(body.virtualParams, g_virtualTexture->shaderParams());
+  reportProgramsReady();
+}
+
+// Same for the feedback pass of the virtual textures
+void finishFeedbackProgram() {
+  g_shaderPipeline->finish(g_feedbackProgram);
+  g_feedbackShader = ShaderProgram::wrap(g_feedbackProgram);
+  g_feedbackUniforms.viewMat = g_feedbackShader->uniform("viewMat");
+  g_feedbackUniforms.projMat = g_feedbackShader->uniform("projMat");
+  g_feedbackUniforms.virtualParams = g_feedbackShader->uniform("virtualParams");
+  g_feedbackUniforms.feedbackParams = g_feedbackShader->uniform("feedbackParams");
+  g_feedbackShader->use();
+  g_feedbackShader->set(g_feedbackUniforms.virtualParams, g_virtualTexture->shaderParams());
+  g_feedbackShader->set(g_feedbackUniforms.feedbackParams, g_virtualTexture->feedbackParams());
+  reportProgramsReady();
+}
+
+// Submits every program the scene may need, so that the driver compiles them while the textures load
+void submitPrograms() {
+  // the vertex shader scales the unorm16 texture coordinates back by Mesh::kTexCoordRange
+  const std::vector<std::string> vertexDefines(1, "#define TEX_COORD_RANGE " + std::to_string(Mesh::kTexCoordRange));
+  g_shaderPipeline.reset(new ShaderPipeline(g_programCache.get(), &g_timeline, vertexDefines));
+  const unsigned lit = kShaderTextured | kShaderLit;
+  bodyProgram(ShaderVariant(kShaderTextured | kShaderEmissive, g_shaderQuality));
+  bodyProgram(ShaderVariant(lit, g_shaderQuality));
+  bodyProgram(ShaderVariant(lit, 0)); // asteroids, see initBodyPrograms()
+  if(g_virtualTextures) {
+    bodyProgram(ShaderVariant(lit | kShaderVirtual, g_shaderQuality));
+    g_feedbackProgram = g_shaderPipeline->submit("feedback", "vertexShader.glsl", "feedbackShader.glsl",
+                                                 std::vector<std::string>());
+  }
+  g_timeline.mark(std::to_string(g_shaderPipeline->pending()) + " programs submitted, "
+                  + (g_shaderPipeline->parallel() ? "GL_KHR_parallel_shader_compile" : "no parallel compilation"));
 }
 
-// Loads and compile a shader, before attaching it to a program
-void loadShader(GLuint program, GLenum type, const std::string &shaderFilename) {
-  GLuint shader = glCreateShader(type); // Create the shader, e.g., a vertex shader to be applied to every single vertex of a mesh
-  std::string shaderSourceString = file2String(shaderFilename); // Loads the shader source from a file to a C++ string
-  const GLchar *shaderSource = (const GLchar *)shaderSourceString.c_str(); // Interface the C++ string through a C pointer
-  glShaderSource(shader, 1, &shaderSource, NULL); // load the vertex shader code
-  glCompileShader(shader);
-  GLint success;
-  GLchar infoLog[512];
-  glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-  if(!success) {
-    glGetShaderInfoLog(shader, 512, NULL, infoLog);
-    std::cout << "ERROR in compiling " << shaderFilename << "\n\t" << infoLog << std::endl;
+// Tiles the close-up maps (once, next to the texture cache) and starts paging them in
+void initVirtualTextures() {
+  const double start = glfwGetTime();
+  const char *names[] = { "earth", "mars" };
+  const int layers[] = { g_layerEarth, g_layerMars };
+  std::unique_ptr<VirtualTexture> virtualTexture(new VirtualTexture());
+  for(size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    const std::string source = std::string("../../media/") + names[i] + ".jpg";
+    const std::string tiles = std::string("../../media/cache/") + names[i] + ".svt";
+    if(!virtualTextureFileIsCurrent(source, tiles, g_virtualWidth, g_virtualHeight)
+       && !buildVirtualTextureFile(source, tiles, g_virtualWidth, g_virtualHeight)) {
+      std::cerr << "WARNING: cannot tile " << source << ", virtual texturing disabled" << std::endl;
+      return;
+    }
+    virtualTexture->addLayer(tiles);
   }
-  glAttachShader(program, shader);
-  glDeleteShader(shader);
+  if(!virtualTexture->start())
+    return;
+  for(size_t i = 0; i < sizeof(layers) / sizeof(layers[0]); ++i)
+    g_virtualLayerOf[layers[i]] = float(i);
+  g_virtualTexture = std::move(virtualTexture);
+  std::cout << "Virtual textures: earth and mars at " << g_virtualWidth << "x" << g_virtualHeight << ", "
+            << g_virtualTexture->residentBytes() / 1024 << " KiB resident (atlas and page tables), "
+            << int(1000.0 * (glfwGetTime() - start)) << " ms" << std::endl;
 }
 
 void initGPUprogram() {
-  g_program = glCreateProgram(); // Create a GPU program, i.e., two central shaders of the graphics pipeline
-  loadShader(g_program, GL_VERTEX_SHADER, "../../vertexShader.glsl");
-  loadShader(g_program, GL_FRAGMENT_SHADER, "../../fragmentShader.glsl");
-  glLinkProgram(g_program); // The main GPU program is ready to be handle streams of polygons
-
-  glUseProgram(g_program);
-  g_texSun   = loadTextureFromFileToGPU("../../media/sun2.jpg");
-  g_texEarth = loadTextureFromFileToGPU("../../media/earth.jpg");
-  g_texMoon  = loadTextureFromFileToGPU("../../media/moon.jpg");
-  g_texMercure  = loadTextureFromFileToGPU("../../media/mercure.jpg");
-  g_texVenus = loadTextureFromFileToGPU("../../media/venus.jpg");
-  g_texMars  = loadTextureFromFileToGPU("../../media/mars.jpg");
-  g_texJupiter  = loadTextureFromFileToGPU("../../media/jupiter.jpg");
-  // g_texSaturne  = loadTextureFromFileToGPU("../../media/saturne.jpg");
-  // g_texUranuss  = loadTextureFromFileToGPU("../../media/uranus.jpg");
-  // g_texNeptune  = loadTextureFromFileToGPU("../../media/neptune.jpg");
-
-
-  glUniform1i(glGetUniformLocation(g_program, "material.albedoTex"), 0);
+  if(g_assets.open("../../assets.pak"))
+    std::cout << "Assets: " << g_assets.entryCount() << " entries mapped from ../../assets.pak" << std::endl;
+  if(g_useProgramCache) {
+    g_programCache.reset(new ProgramCache("../../media/cache"));
+    if(!g_programCache->available()) {
+      std::cout << "GL_ARB_get_program_binary not available, shaders are compiled at every launch" << std::endl;
+      g_programCache.reset();
+    }
+  }
+  submitPrograms();
+
+  g_textureStart = glfwGetTime();
+  g_textureCache.reset(new TextureCache("../../media/cache"));
+  g_textureCache->setArchive(&g_assets);
+  const char *planetFiles[] = {
+    "../../media/sun2.jpg", "../../media/earth.jpg", "../../media/moon.jpg", "../../media/mercure.jpg",
+    "../../media/venus.jpg", "../../media/mars.jpg", "../../media/jupiter.jpg",
+    // "../../media/saturne.jpg", "../../media/uranus.jpg", "../../media/neptune.jpg",
+  };
+  int *planetLayers[] = { &g_layerSun, &g_layerEarth, &g_layerMoon, &g_layerMercure,
+                          &g_layerVenus, &g_layerMars, &g_layerJupiter };
+  // Mip filter per map: all of these are sRGB albedo; a normal or height map would take MipFilter::Box
+  const MipFilter planetFilters[] = { MipFilter::Tent, MipFilter::Tent, MipFilter::Tent, MipFilter::Tent,
+                                      MipFilter::Tent, MipFilter::Tent, MipFilter::Tent };
+  if(g_streamTextures) {
+    // Returns at once with grey placeholders; the maps sharpen over the first frames
+    g_textureStreamer.reset(new TextureStreamer());
+    g_textureStreamer->setArchive(&g_assets);
+    if(g_compressTextures && !GLAD_GL_EXT_texture_compression_s3tc)
+      std::cout << "GL_EXT_texture_compression_s3tc not available, streaming uncompressed RGBA8" << std::endl;
+    else
+      g_textureStreamer->setCompressed(g_compressTextures);
+    for(size_t i = 0; i < sizeof(planetFiles) / sizeof(planetFiles[0]); ++i)
+      *planetLayers[i] = g_textureStreamer->addLayer(planetFiles[i], planetFilters[i]);
+    g_texPlanets = g_textureStreamer->start(g_textureCache.get());
+    std::cout << "Planet maps: " << g_textureStreamer->residentBytes() / 1024 << " KiB, streamed "
+              << (g_textureStreamer->compressed() ? "as BC1, " : "as RGBA8, ")
+              << int(1000.0 * (glfwGetTime() - g_textureStart)) << " ms to first frame" << std::endl;
+  } else {
+    TextureArray planetMaps;
+    planetMaps.setMipMode(g_mipMode);
+    planetMaps.setCache(g_textureCache.get());
+    planetMaps.setArchive(&g_assets);
+    for(size_t i = 0; i < sizeof(planetFiles) / sizeof(planetFiles[0]); ++i)
+      *planetLayers[i] = planetMaps.addLayer(planetFiles[i], planetFilters[i]);
+    g_texPlanets = planetMaps.build();
+    std::cout << "Planet maps: " << planetMaps.residentBytes() / 1024 << " KiB, mipmaps: "
+              << mipModeName(g_mipMode) << ", cache hits: " << g_textureCache->hits() << "/"
+              << g_textureCache->hits() + g_textureCache->misses() << ", "
+              << int(1000.0 * (glfwGetTime() - g_textureStart)) << " ms" << std::endl;
+  }
+
+  g_virtualLayerOf.assign(sizeof(planetFiles) / sizeof(planetFiles[0]), -1.f);
+  if(g_virtualTextures)
+    initVirtualTextures();
   // TODO: set shader variables, textures, etc.
 }
 
@@ -291,6 +518,8 @@ void initCamera() {
   int width, height;
   glfwGetWindowSize(g_window, &width, &height);
   g_camera.setAspectRatio(static_cast<float>(width)/static_cast<float>(height));
+  g_viewportWidth = std::max(width, 1);
+  g_viewportHeight = std::max(height, 1);
 
   g_camera.setPosition(glm::vec3(0.0, 0.0, 23.0));
   g_camera.setNear(0.1);
@@ -320,113 +549,203 @@ const static float kRadOrbitSaturne = 13;
 const static float kRadOrbitUranus = 14;
 const static float kRadOrbitNeptune = 15;
 
+// Gravitational mode: masses in simulation units (G = 1)
+const static float kMassSun = 100;
+const static float kMassJupiter = 0.1;
+const static float kMassEarth = 0.0003;
+const static size_t kAsteroidCount = 2000;
+const static float kSizeAsteroid = 0.03;
+const static float kRadBeltInner = 9.6;
+const static float kRadBeltOuter = 10.4;
+
+
+// All bodies of the system, parents before their satellites
+Planet g_planets;
+int g_sunIndex = 0;
+
+// Small bodies integrated with Barnes-Hut, attracted by the bodies of g_planets
+NBody g_asteroids;
+std::vector<float> g_attractorMasses;
+std::vector<glm::vec3> g_attractorPositions;
+
+// Last two simulated states (g_planets bodies, then asteroids), private to the simulation thread
+SimState g_prevState, g_currState;
+// Models interpolated by the GL thread from the last published SimFrame
+std::vector<glm::mat4> g_renderModels;
+
+// Bounding spheres of every body (center and radius arrays), tested against the view frustum
+std::vector<float> g_boundX, g_boundY, g_boundZ, g_boundRadius;
+std::vector<unsigned char> g_visible;
+
+// Sphere meshes from coarse to fine; each body picks one from its size on screen
+const static std::vector<size_t> kSphereLodSegments = {8, 16, 32, 64, 128};
+std::vector<std::shared_ptr<Mesh>> g_sphereLods;
+LodSelector g_sphereLodSelector = LodSelector::forSphereSegments(kSphereLodSegments);
+
+void initScene() {
+  // Arguments: parent, size, orbit radius, orbit period, orbit phase (deg), axial tilt (deg), spin rate, texture layer
+  g_sunIndex = g_planets.add(-1, kSizeSun, 0.f, 0.f, 0.f, 0.f, 0.f, g_layerSun, true); // Soleil
+  const int earth = g_planets.add(-1, kSizeEarth, kRadOrbitEarth, 2.f, 0.f, 23.5f, 1.f, g_layerEarth); // Terre
+  const int moon = g_planets.add(earth, kSizeMoon, kRadOrbitMoon, 0.5f, 0.f, 0.f, 2.f, g_layerMoon); // Lune
+  const int mercure = g_planets.add(-1, kSizeMercure, kRadOrbitMercure, 0.3f, 0.f, 0.03f, 1.f/3.f, g_layerMercure); // Mercure
+  const int venus = g_planets.add(-1, kSizeVenus, kRadOrbitVenus, 0.62f, 0.f, 177.f, -1.f/10.f, g_layerVenus); // Venus
+  const int mars = g_planets.add(-1, kSizeMars, kRadOrbitMars, 1.88f, 45.f, 25.f, 1.f/1.03f, g_layerMars); // Mars
+  const int jupiter = g_planets.add(-1, kSizeJupiter, kRadOrbitJupiter, 11.86f, 0.f, 3.1f, 2.5f, g_layerJupiter); // Jupiter
+
+  // Real orbital elements: eccentricity, inclination, ascending node, argument of periapsis (deg)
+  g_planets.setOrbitElements(earth, 0.0167f, 0.f, -11.26f, 114.21f);
+  g_planets.setOrbitElements(moon, 0.0549f, 5.145f, 125.08f, 318.15f);
+  g_planets.setOrbitElements(mercure, 0.2056f, 7.005f, 48.33f, 29.12f);
+  g_planets.setOrbitElements(venus, 0.0068f, 3.395f, 76.68f, 54.88f);
+  g_planets.setOrbitElements(mars, 0.0934f, 1.850f, 49.56f, 286.50f);
+  g_planets.setOrbitElements(jupiter, 0.0489f, 1.303f, 100.46f, 273.87f);
+
+  g_attractorMasses.assign(g_planets.size(), 0.f);
+  g_attractorMasses[g_sunIndex] = kMassSun;
+  g_attractorMasses[earth] = kMassEarth;
+  g_attractorMasses[jupiter] = kMassJupiter;
+}
+
+// Asteroid belt between Mars and Jupiter, on circular orbits around the Sun
+void initAsteroids() {
+  std::srand(2025);
+  for(size_t i = 0; i < kAsteroidCount; ++i) {
+    const float r = kRadBeltInner + (kRadBeltOuter - kRadBeltInner) * float(std::rand()) / float(RAND_MAX);
+    const float a = 2.f * float(M_PI) * float(std::rand()) / float(RAND_MAX);
+    const float h = 0.3f * (float(std::rand()) / float(RAND_MAX) - 0.5f);
+    const float v = std::sqrt(kMassSun / r);
+    g_asteroids.add(glm::vec3(r * std::cos(a), h, -r * std::sin(a)),
+                    glm::vec3(-v * std::sin(a), 0.f, -v * std::cos(a)), 1e-6f);
+  }
+}
 
-// Transformations (model matrices)
-glm::mat4 g_sun, g_earth, g_moon,g_mercure;
-glm::mat4 g_venus, g_mars, g_jupiter;
+// Picks the shader variant of every body among the submitted ones, and drops those no body uses
+void initBodyPrograms() {
+  g_planetProgram.resize(g_planets.size());
+  for(size_t i = 0; i < g_planets.size(); ++i) {
+    ShaderVariant variant(kShaderTextured | (g_planets.emissive(i) ? kShaderEmissive : kShaderLit), g_shaderQuality);
+    if(g_virtualLayerOf[size_t(g_planets.textureLayer(i))] >= 0.f)
+      variant.features |= kShaderVirtual;
+    g_planetProgram[i] = &bodyProgram(variant);
+  }
+  g_asteroidProgram = &bodyProgram(ShaderVariant(kShaderTextured | kShaderLit, 0)); // too small on screen for a visible highlight
+
+  // e.g. the virtual texture variant when tiling failed
+  for(size_t p = g_bodyPrograms.size(); p-- > 0;) {
+    BodyProgram *body = g_bodyPrograms[p].get();
+    if(body == g_asteroidProgram || std::find(g_planetProgram.begin(), g_planetProgram.end(), body) != g_planetProgram.end())
+      continue;
+    g_shaderPipeline->cancel(body->program);
+    g_bodyPrograms.erase(g_bodyPrograms.begin() + long(p));
+  }
+  if(g_feedbackProgram && !g_virtualTexture) {
+    g_shaderPipeline->cancel(g_feedbackProgram);
+    g_feedbackProgram = 0;
+  }
 
+  std::cout << "Shader variants:";
+  for(size_t p = 0; p < g_bodyPrograms.size(); ++p)
+    std::cout << (p ? ", " : " ") << g_bodyPrograms[p]->variant.name();
+  std::cout << std::endl;
+}
 
-auto sphere =  Mesh::genSphere(32);
 void init() {
   initGLFW();
   initOpenGL();
+  g_timeline.mark("Window and OpenGL context ready");
   initCPUgeometry();
   initGPUprogram();
+  g_timeline.mark("Planet maps and virtual textures started");
   initGPUgeometry();
   initCamera();
-  sphere->init();
+  initScene();
+  initBodyPrograms();
+  g_timeline.mark("Scene built");
+  for(size_t i = 0; i < kSphereLodSegments.size(); ++i) {
+    g_sphereLods.push_back(Mesh::genSphere(kSphereLodSegments[i]));
+    g_sphereLods.back()->init(true); // rendering only needs the GPU copy
+  }
+  size_t lodBytes = 0;
+  for(size_t i = 0; i < g_sphereLods.size(); ++i)
+    lodBytes += g_sphereLods[i]->gpuBytes();
+  std::cout << "Sphere LODs: " << lodBytes / 1024 << " KiB of vertices and indices" << std::endl;
+  g_timeline.mark("Sphere LODs generated");
 
 }
 
 void clear() {
-  glDeleteProgram(g_program);
+  for(size_t p = 0; p < g_bodyPrograms.size(); ++p)
+    glDeleteProgram(g_bodyPrograms[p]->program);
+  g_bodyPrograms.clear();
+  g_shaderPipeline.reset(); // deletes the shaders of programs never used
+  g_programCache.reset();
+  g_virtualTexture.reset();
+  glDeleteProgram(g_feedbackProgram);
+  g_textureStreamer.reset(); // joins the decoding threads before the cache goes away
+  g_textureCache.reset();
+  glDeleteTextures(1, &g_texPlanets);
 
   glfwDestroyWindow(g_window);
   glfwTerminate();
 }
 
-// Update any accessible variable based on the current time
-void update(const float currentTimeInSec) {
-  // std::cout << currentTimeInSec << std::endl;
-
-        double t = glfwGetTime() *0.7;
-
-        // Soleil
-        g_sun = glm::scale(glm::mat4(1.0f), glm::vec3(kSizeSun));
-
-        // Terre
-        float angleEarthRot   = (float)t;
-        float angleEarthOrbit = (float)t / 2.0f;
-
-        g_earth = glm::mat4(1.0f);
-        g_earth = glm::rotate(g_earth, angleEarthOrbit, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_earth = glm::translate(g_earth, glm::vec3(kRadOrbitEarth, 0.0f, 0.0f));
-        g_earth = glm::rotate(g_earth, glm::radians(23.5f), glm::vec3(1.0f, 0.0f, 0.0f));
-        g_earth = glm::rotate(g_earth, angleEarthRot, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_earth = glm::scale(g_earth, glm::vec3(kSizeEarth));
-
-        // Lune
-        float angleMoonOrbit = (float)t * 2.0f;
-        float angleMoonRot   = angleMoonOrbit;
-
-        g_moon = glm::mat4(1.0f);
-        g_moon = glm::rotate(g_moon, angleEarthOrbit, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_moon = glm::translate(g_moon, glm::vec3(kRadOrbitEarth, 0.0f, 0.0f));
-        g_moon = glm::rotate(g_moon, angleMoonOrbit, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_moon = glm::translate(g_moon, glm::vec3(kRadOrbitMoon, 0.0f, 0.0f));
-        g_moon = glm::rotate(g_moon, angleMoonRot, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_moon = glm::scale(g_moon, glm::vec3(kSizeMoon));
-
-
-        // Mercure
-        float angleMercureOrbit = (float)t / 0.3f;
-        float angleMercureRot   = (float)t / 3.0f;
-
-        g_mercure = glm::mat4(1.0f);
-        g_mercure = glm::rotate(g_mercure, angleMercureOrbit, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_mercure = glm::translate(g_mercure, glm::vec3(kRadOrbitMercure, 0.0f, 0.0f));
-        g_mercure = glm::rotate(g_mercure, glm::radians(0.03f), glm::vec3(1.0f, 0.0f, 0.0f));
-        g_mercure = glm::rotate(g_mercure, angleMercureRot, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_mercure = glm::scale(g_mercure, glm::vec3(kSizeMercure));
-
-        // Venus
-        float angleVenusOrbit = (float)t / 0.62f;
-        float angleVenusRot   = -(float)t / 10.0f;
-
-        g_venus = glm::mat4(1.0f);
-        g_venus = glm::rotate(g_venus, angleVenusOrbit, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_venus = glm::translate(g_venus, glm::vec3(kRadOrbitVenus, 0.0f, 0.0f));
-        g_venus = glm::rotate(g_venus, glm::radians(177.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        g_venus = glm::rotate(g_venus, angleVenusRot, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_venus = glm::scale(g_venus, glm::vec3(kSizeVenus));
-
-        //mars
-        float angleMarsOrbit = (float)t / 1.88f + glm::radians(45.0f);
-        float angleMarsRot   = (float)t / 1.03f;
-
-        g_mars = glm::mat4(1.0f);
-        g_mars = glm::rotate(g_mars, angleMarsOrbit, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_mars = glm::translate(g_mars, glm::vec3(kRadOrbitMars, 0.0f, 0.0f));
-        g_mars = glm::rotate(g_mars, glm::radians(25.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        g_mars = glm::rotate(g_mars, angleMarsRot, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_mars = glm::scale(g_mars, glm::vec3(kSizeMars));
-
-        // Jupiter
-        float angleJupiterOrbit = (float)t / 11.86f;
-        float angleJupiterRot   = (float)t * 2.5f;
-
-        g_jupiter = glm::mat4(1.0f);
-        g_jupiter = glm::rotate(g_jupiter, angleJupiterOrbit, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_jupiter = glm::translate(g_jupiter, glm::vec3(kRadOrbitJupiter, 0.0f, 0.0f));
-        g_jupiter = glm::rotate(g_jupiter, glm::radians(3.1f), glm::vec3(1.0f, 0.0f, 0.0f));
-        g_jupiter = glm::rotate(g_jupiter, angleJupiterRot, glm::vec3(0.0f, 1.0f, 0.0f));
-        g_jupiter = glm::scale(g_jupiter, glm::vec3(kSizeJupiter));
-
-
+// Advances the simulation by one fixed step, up to simTime
+void update(const double simTime) {
+  const bool gravity = g_gravity;
+  g_planets.update(simTime);
+
+  if(gravity) {
+    if(g_asteroids.size() == 0)
+      initAsteroids();
+    g_attractorPositions.resize(g_planets.size());
+    for(size_t i = 0; i < g_planets.size(); ++i)
+      g_attractorPositions[i] = g_planets.position(i);
+    g_asteroids.setAttractors(g_attractorPositions, g_attractorMasses);
+    g_asteroids.step(float(g_clock.step()));
+  }
 
+  std::swap(g_prevState, g_currState);
+  g_currState.time = simTime;
+  const size_t planets = g_planets.size(), asteroids = gravity ? g_asteroids.size() : 0;
+  g_currState.models.resize(planets + asteroids);
+  std::copy(g_planets.models().begin(), g_planets.models().end(), g_currState.models.begin());
+  JobSystem::shared().parallelFor(asteroids, 512, [planets](size_t begin, size_t end) {
+    for(size_t i = begin; i < end; ++i)
+      g_currState.models[planets + i] = glm::scale(glm::translate(glm::mat4(1.0f), g_asteroids.position(i)), glm::vec3(kSizeAsteroid));
+  });
 }
 
+// Copies the last two states into the free slot of g_frames and hands it to the GL thread
+void publishFrame(const double now) {
+  SimFrame &frame = g_frames.back();
+  frame.prev = g_prevState; // assignments reuse the slot's storage
+  frame.curr = g_currState;
+  frame.alpha = g_clock.alpha();
+  frame.publishedAt = now;
+  frame.stepsPerSecond = g_clock.paused() ? 0.0 : g_clock.warp() / g_clock.step();
+  g_frames.publish();
+}
 
+// Body of g_simThread: steps the simulation in real time, independently of rendering
+void simulationLoop() {
+  double lastTime = glfwGetTime();
+  while(g_simRunning) {
+    const bool changed = g_clock.paused() != g_simPaused || g_clock.warp() != g_simWarp;
+    g_clock.setPaused(g_simPaused);
+    g_clock.setWarp(g_simWarp);
+
+    const double now = glfwGetTime();
+    const int steps = g_clock.advance(now - lastTime);
+    lastTime = now;
+    for(int k = steps - 1; k >= 0; --k)
+      update(g_clock.time() - k * g_clock.step());
+
+    if(steps > 0 || changed)
+      publishFrame(now);
+    else
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
 
 // The main rendering call
 void render() {
@@ -434,92 +753,184 @@ void render() {
     const glm::mat4 viewMatrix = g_camera.computeViewMatrix();
     const glm::mat4 projMatrix = g_camera.computeProjectionMatrix();
 
-    glUseProgram(g_program);
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "viewMat"), 1, GL_FALSE, glm::value_ptr(viewMatrix));
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "projMat"), 1, GL_FALSE, glm::value_ptr(projMatrix));
-
     glm::vec3 camPos = g_camera.getPosition();
-    glUniform3fv(glGetUniformLocation(g_program, "camPos"), 1, glm::value_ptr(camPos));
-
-    glUniform1i(glGetUniformLocation(g_program, "material.albedoTex"), 0);
-
-    //Soleil
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "modelMat"), 1, GL_FALSE, glm::value_ptr(g_sun));
-    glUniform3f(glGetUniformLocation(g_program, "objectColor"), 1.0f, 1.0f, 0.2f);
-    glUniform1i(glGetUniformLocation(g_program, "isLightSource"), 1);
-
-    glm::vec3 lightPos = glm::vec3(g_sun[3]); // position du Soleil dans le monde
-    glUniform3fv(glGetUniformLocation(g_program, "lightPos"), 1, glm::value_ptr(lightPos));
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_texSun);
-    sphere->render();
-
-    // Terre
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "modelMat"), 1, GL_FALSE, glm::value_ptr(g_earth));
-
-    glUniform1i(glGetUniformLocation(g_program, "isLightSource"), 0);
-    glUniform3f(glGetUniformLocation(g_program, "objectColor"), 0.2f, 1.0f, 0.2f);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_texEarth);
-    sphere->render();
 
-    // Lune
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "modelMat"), 1, GL_FALSE, glm::value_ptr(g_moon));
+    if(g_textureStreamer) {
+      g_textureStreamer->update(kTextureUploadBudget);
+      if(g_textureStreamer->done()) {
+        std::cout << "Planet maps: streaming done in " << int(1000.0 * (glfwGetTime() - g_textureStart))
+                  << " ms, cache hits: " << g_textureCache->hits() << "/"
+                  << g_textureCache->hits() + g_textureCache->misses() << std::endl;
+        g_textureStreamer.reset(); // g_texPlanets stays, fully resident
+      }
+    }
+
+    g_frames.update(); // never waits: keeps the previous frame if nothing new was published
+    const SimFrame &frame = g_frames.front();
+    interpolateStates(frame.prev, frame.curr, frame.alphaAt(glfwGetTime()), g_renderModels);
+
+    glm::vec3 lightPos = glm::vec3(g_renderModels[g_sunIndex][3]); // position du Soleil dans le monde
+
+    const size_t bodies = g_renderModels.size();
+    g_boundX.resize(bodies);
+    g_boundY.resize(bodies);
+    g_boundZ.resize(bodies);
+    g_boundRadius.resize(bodies);
+    g_visible.resize(bodies);
+    for(size_t i = 0; i < bodies; ++i) {
+      g_boundX[i] = g_renderModels[i][3].x;
+      g_boundY[i] = g_renderModels[i][3].y;
+      g_boundZ[i] = g_renderModels[i][3].z;
+      g_boundRadius[i] = i < g_planets.size() ? g_planets.bodySize(i) : kSizeAsteroid; // unit sphere scaled by kSize*
+    }
+    cullSpheres(Frustum(projMatrix * viewMatrix), bodies, g_boundX.data(), g_boundY.data(), g_boundZ.data(),
+                g_boundRadius.data(), g_visible.data());
+
+    // Per-instance data of every visible body, one instanced draw per variant and LOD level
+    for(size_t p = 0; p < g_bodyPrograms.size(); ++p) {
+      g_bodyPrograms[p]->instances.resize(g_sphereLods.size());
+      for(size_t l = 0; l < g_sphereLods.size(); ++l)
+        g_bodyPrograms[p]->instances[l].clear();
+    }
+    const float fovY = glm::radians(g_camera.getFov());
+    g_visibleLastFrame = 0;
+    for(size_t i = 0; i < bodies; ++i) {
+      if(!g_visible[i])
+        continue;
+      const glm::vec3 center(g_boundX[i], g_boundY[i], g_boundZ[i]);
+      const float pixels = projectedPixelRadius(g_boundRadius[i], glm::distance(center, camPos), fovY, float(g_viewportHeight));
+      const int level = g_sphereLodSelector.select(i, pixels);
+
+      const bool planet = i < g_planets.size(); // asteroids follow the planets
+      Mesh::InstanceData instance;
+      instance.model = g_renderModels[i];
+      instance.layer = float(planet ? g_planets.textureLayer(i) : g_layerMoon);
+      instance.minLod = g_textureStreamer ? g_textureStreamer->minLod(int(instance.layer)) : 0.f;
+      instance.virtualLayer = planet ? g_virtualLayerOf[size_t(instance.layer)] : -1.f;
+      BodyProgram &body = planet ? *g_planetProgram[i] : *g_asteroidProgram;
+      body.instances[level].push_back(instance);
+      ++g_visibleLastFrame;
+    }
+    g_bodiesLastFrame = bodies;
+
+    // One upload per LOD mesh; the feedback and main passes then draw ranges of it
+    g_lodInstances.resize(g_sphereLods.size());
+    for(size_t l = 0; l < g_sphereLods.size(); ++l) {
+      std::vector<Mesh::InstanceData> &all = g_lodInstances[l];
+      all.clear();
+      for(size_t p = 0; p < g_bodyPrograms.size(); ++p) {
+        BodyProgram &body = *g_bodyPrograms[p];
+        body.firstInstance.resize(g_sphereLods.size());
+        body.firstInstance[l] = all.size();
+        all.insert(all.end(), body.instances[l].begin(), body.instances[l].end());
+      }
+      g_sphereLods[l]->uploadInstances(all.data(), all.size());
+    }
+
+    if(g_virtualTexture) {
+      // Pages in the tiles seen two frames ago, then records what this frame needs at low resolution
+      g_virtualTexture->update(kTileUploadsPerFrame);
+      g_virtualTexture->beginFeedback(g_viewportWidth, g_viewportHeight);
+      if(!g_feedbackShader)
+        finishFeedbackProgram();
+      g_feedbackShader->use();
+      g_feedbackShader->set(g_feedbackUniforms.viewMat, viewMatrix);
+      g_feedbackShader->set(g_feedbackUniforms.projMat, projMatrix);
+      for(size_t l = 0; l < g_sphereLods.size(); ++l)
+        g_sphereLods[l]->drawInstances(0, g_lodInstances[l].size()); // one shader for every variant
+      g_virtualTexture->endFeedback();
+      g_feedbackShader->endFrame();
+
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, g_virtualTexture->atlas());
+      glActiveTexture(GL_TEXTURE2);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, g_virtualTexture->pageTable());
+    }
 
-    glUniform1i(glGetUniformLocation(g_program, "isLightSource"), 0);
-    glUniform3f(glGetUniformLocation(g_program, "objectColor"), 0.3f, 0.3f, 1.0f);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_texMoon);
-    sphere->render();
-
-
-    // mercure
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "modelMat"), 1, GL_FALSE, glm::value_ptr(g_mercure));
-
-    glUniform1i(glGetUniformLocation(g_program, "isLightSource"), 0);
-    glUniform3f(glGetUniformLocation(g_program, "objectColor"), 0.5f, 0.5f, 0.5f);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_texMercure);
-    sphere->render();
-
-    // venus
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "modelMat"), 1, GL_FALSE, glm::value_ptr(g_venus));
-
-    glUniform1i(glGetUniformLocation(g_program, "isLightSource"), 0);
-    glUniform3f(glGetUniformLocation(g_program, "objectColor"), 0.5f, 0.5f, 0.5f);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_texVenus);
-    sphere->render();
-
-    // mars
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "modelMat"), 1, GL_FALSE, glm::value_ptr(g_mars));
-
-    glUniform1i(glGetUniformLocation(g_program, "isLightSource"), 0);
-    glUniform3f(glGetUniformLocation(g_program, "objectColor"), 0.5f, 0.5f, 0.5f);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_texMars);
-    sphere->render();
-
-    // Jupiter
-    glUniformMatrix4fv(glGetUniformLocation(g_program, "modelMat"), 1, GL_FALSE, glm::value_ptr(g_jupiter));
-
-    glUniform1i(glGetUniformLocation(g_program, "isLightSource"), 0);
-    glUniform3f(glGetUniformLocation(g_program, "objectColor"), 0.5f, 0.5f, 0.5f);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_texJupiter);
-    sphere->render();
-
+    glBindTexture(GL_TEXTURE_2D_ARRAY, g_texPlanets);
+    g_trianglesLastFrame = 0;
+    for(size_t p = 0; p < g_bodyPrograms.size(); ++p) {
+      BodyProgram &body = *g_bodyPrograms[p];
+      bool bound = false;
+      for(size_t l = 0; l < g_sphereLods.size(); ++l) {
+        if(body.instances[l].empty())
+          continue;
+        if(!bound) {
+          // Uniforms of a variant no body uses this frame are left untouched
+          if(!body.shader)
+            finishBodyProgram(body);
+          body.shader->use();
+          body.shader->set(body.viewMat, viewMatrix);
+          body.shader->set(body.projMat, projMatrix);
+          body.shader->set(body.camPos, camPos);
+          body.shader->set(body.lightPos, lightPos);
+          bound = true;
+        }
+        g_sphereLods[l]->drawInstances(body.firstInstance[l], body.instances[l].size());
+        g_trianglesLastFrame += body.instances[l].size() * g_sphereLods[l]->triangleCount();
+      }
+      if(body.shader)
+        body.shader->endFrame();
+    }
 }
 
 
 int main(int argc, char ** argv) {
+  bool mipModeGiven = false;
+  for(int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if(arg.compare(0, 7, "--mips=") == 0 && !(mipModeGiven = parseMipMode(arg.substr(7), g_mipMode)))
+      std::cerr << "WARNING: unknown mip mode " << arg.substr(7) << ", expected none, gpu or cpu" << std::endl;
+    else if(arg == "--no-stream")
+      g_streamTextures = false;
+    else if(arg == "--no-compress")
+      g_compressTextures = false;
+    else if(arg == "--no-virtual")
+      g_virtualTextures = false;
+    else if(arg == "--no-program-cache")
+      g_useProgramCache = false;
+    else if(arg.compare(0, 17, "--shader-quality=") == 0) {
+      g_shaderQuality = std::atoi(arg.c_str() + 17);
+      if(g_shaderQuality != 0 && g_shaderQuality != 1) {
+        std::cerr << "WARNING: unknown shader quality " << arg.substr(17) << ", expected 0 or 1" << std::endl;
+        g_shaderQuality = 1;
+      }
+    }
+    else if(arg.compare(0, 15, "--virtual-size=") == 0) {
+      // parsed into locals: a malformed value must not leave half a size behind
+      int width = 0, height = 0;
+      const auto powerOfTwo = [](int n) { return n > 0 && (n & (n - 1)) == 0; };
+      if(std::sscanf(arg.c_str() + 15, "%dx%d", &width, &height) == 2 && powerOfTwo(width) && powerOfTwo(height)) {
+        g_virtualWidth = width;
+        g_virtualHeight = height;
+      } else
+        std::cerr << "WARNING: invalid virtual texture size " << arg.substr(15) << ", expected WxH with powers of two" << std::endl;
+    }
+  }
+  if(mipModeGiven && g_streamTextures && g_mipMode != MipMode::Cpu) {
+    // the streamer uploads CPU-built chains level by level; other modes need the whole-array path
+    std::cout << "--mips=" << mipModeName(g_mipMode) << ": streamed textures only use CPU mipmaps, loading the planet maps without streaming" << std::endl;
+    g_streamTextures = false;
+  }
   init(); // Your initialization code (user interface, OpenGL states, scene with geometry, material, lights, etc)
+  g_clock.setWarp(g_simWarp);
+  update(g_clock.time());
+  update(g_clock.time()); // both interpolation states are valid from the first frame
+  publishFrame(glfwGetTime());
+  g_simRunning = true;
+  g_simThread = std::thread(simulationLoop);
     while(!glfwWindowShouldClose(g_window)) {
-    update(static_cast<float>(glfwGetTime()));
     render();
     glfwSwapBuffers(g_window);
+    if(!g_firstFramePresented) {
+      g_timeline.mark("First frame presented");
+      g_firstFramePresented = true;
+    }
     glfwPollEvents();
   }
+  g_simRunning = false;
+  g_simThread.join();
   clear();
   return EXIT_SUCCESS;
 }
@@ -1,3 +1,118 @@
 #include "planet.h"
+#include "Kepler.h"
+#include "OrbitKernel.h"
+#include "JobSystem.h"
+
+#include <cassert>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Corps par tâche pour les deux noyaux : multiple de la largeur SIMD, et
+// assez grand pour que l'envoi d'une tâche reste négligeable.
+static const size_t kBodiesPerJob = 2048;
 
 Planet::Planet() {}
+
+int Planet::add(int parent, float size, float orbitRadius, float orbitPeriod,
+                float orbitPhaseDeg, float axialTiltDeg, float spinRate,
+                int textureLayer, bool emissive) {
+    assert(parent < int(m_size.size()));
+    const int index = int(m_size.size());
+    m_parent.push_back(parent);
+    m_frameOf.push_back(-1);
+    if (parent >= 0) {
+        // un parent racine n'entre dans le graphe qu'à son premier satellite
+        if (m_frameOf[parent] < 0) {
+            m_frameOf[parent] = m_frames.add(-1);
+            m_framed.push_back(parent);
+        }
+        m_frameOf[index] = m_frames.add(m_frameOf[parent]);
+        m_framed.push_back(index);
+    }
+
+    m_size.push_back(size);
+    m_axialTilt.push_back(glm::radians(axialTiltDeg));
+    m_cosTilt.push_back(std::cos(m_axialTilt.back()));
+    m_sinTilt.push_back(std::sin(m_axialTilt.back()));
+    m_spinRate.push_back(spinRate);
+    m_textureLayer.push_back(textureLayer);
+    m_emissive.push_back(emissive ? 1 : 0);
+
+    m_semiMajorAxis.push_back(orbitRadius);
+    m_eccentricity.push_back(0.f);
+    m_meanMotion.push_back(orbitPeriod != 0.f ? 1.f / orbitPeriod : 0.f);
+    m_meanAnomaly0.push_back(glm::radians(orbitPhaseDeg));
+    m_px.push_back(0.f); m_py.push_back(0.f); m_pz.push_back(0.f);
+    m_qx.push_back(0.f); m_qy.push_back(0.f); m_qz.push_back(0.f);
+    setOrbitElements(index, 0.f, 0.f, 0.f, 0.f);
+
+    m_posX.push_back(0.f); m_posY.push_back(0.f); m_posZ.push_back(0.f);
+    m_model.push_back(glm::mat4(1.0f));
+    return index;
+}
+
+void Planet::setOrbitElements(int body, float eccentricity, float inclinationDeg,
+                              float ascendingNodeDeg, float argPeriapsisDeg) {
+    assert(eccentricity >= 0.f && eccentricity < 1.f);
+    glm::vec3 p, q;
+    keplerAxes(m_semiMajorAxis[body], eccentricity, glm::radians(inclinationDeg),
+               glm::radians(ascendingNodeDeg), glm::radians(argPeriapsisDeg), p, q);
+    m_eccentricity[body] = eccentricity;
+    m_px[body] = p.x; m_py[body] = p.y; m_pz[body] = p.z;
+    m_qx[body] = q.x; m_qy[body] = q.y; m_qz[body] = q.z;
+}
+
+void Planet::propagate(double t) {
+    // chaque corps est indépendant : une tranche de tableaux par tâche
+    JobSystem::shared().parallelFor(m_size.size(), kBodiesPerJob, [this, t](size_t begin, size_t end) {
+        const KeplerBatch orbits = { &m_eccentricity[begin], &m_meanMotion[begin], &m_meanAnomaly0[begin],
+                                     &m_px[begin], &m_py[begin], &m_pz[begin],
+                                     &m_qx[begin], &m_qy[begin], &m_qz[begin] };
+        propagateKepler(end - begin, t, orbits, &m_posX[begin], &m_posY[begin], &m_posZ[begin]);
+    });
+
+    // Kepler donne la position relative au parent : le graphe de scène
+    // compose les repères des hiérarchies, en série (parent avant satellites).
+    // Une orbite immobile garde la même matrice locale et n'est pas recalculée.
+    for (size_t k = 0; k < m_framed.size(); ++k) {
+        const int i = m_framed[k];
+        m_frames.setLocal(int(k), glm::translate(glm::mat4(1.0f), glm::vec3(m_posX[i], m_posY[i], m_posZ[i])));
+    }
+    m_frames.update();
+    for (size_t k = 0; k < m_framed.size(); ++k) {
+        const int i = m_framed[k];
+        const glm::vec4 &pos = m_frames.world(k)[3];
+        m_posX[i] = pos.x; m_posY[i] = pos.y; m_posZ[i] = pos.z;
+    }
+}
+
+void Planet::update(double t) {
+    propagate(t);
+
+    JobSystem::shared().parallelFor(m_size.size(), kBodiesPerJob, [this, t](size_t begin, size_t end) {
+        const OrbitBatch in = { &m_posX[begin], &m_posY[begin], &m_posZ[begin],
+                                &m_cosTilt[begin], &m_sinTilt[begin], &m_spinRate[begin], &m_size[begin] };
+        computeOrbitalModels(end - begin, t, in, &m_model[begin]);
+    });
+}
+
+void Planet::updateReference(double t) {
+    const glm::vec3 yAxis(0.0f, 1.0f, 0.0f);
+    const glm::vec3 xAxis(1.0f, 0.0f, 0.0f);
+
+    for (size_t i = 0; i < m_size.size(); ++i) {
+        const float e = m_eccentricity[i];
+        const float E = solveKepler(wrapAngle(double(m_meanAnomaly0[i]) + double(m_meanMotion[i]) * t), e);
+        glm::vec3 pos = glm::vec3(m_px[i], m_py[i], m_pz[i]) * (std::cos(E) - e)
+                      + glm::vec3(m_qx[i], m_qy[i], m_qz[i]) * std::sin(E);
+        // les parents précèdent leurs satellites : leur position est déjà à jour
+        if (m_parent[i] >= 0)
+            pos += position(m_parent[i]);
+        m_posX[i] = pos.x; m_posY[i] = pos.y; m_posZ[i] = pos.z;
+
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
+        model = glm::rotate(model, m_axialTilt[i], xAxis);
+        model = glm::rotate(model, wrapAngle(t * double(m_spinRate[i])), yAxis);
+        m_model[i] = glm::scale(model, glm::vec3(m_size[i]));
+    }
+}
@@ -1,10 +1,79 @@
 #ifndef PLANET_H
 #define PLANET_H
 
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "SceneGraph.h"
+
+// Stockage des corps célestes en structure de tableaux : chaque
+// paramètre orbital est un tableau contigu indexé par corps.
+// Un parent doit toujours être ajouté avant ses satellites.
 class Planet
 {
 public:
     Planet();
+
+    // Renvoie l'indice du corps ajouté, sur une orbite circulaire dans le plan
+    // XZ. parent = -1 : orbite autour de l'origine. orbitPeriod = 0 : corps
+    // immobile sur son orbite. Angles en degrés.
+    int add(int parent, float size, float orbitRadius, float orbitPeriod,
+            float orbitPhaseDeg, float axialTiltDeg, float spinRate,
+            int textureLayer, bool emissive = false);
+    // Rend l'orbite elliptique : orbitRadius devient le demi-grand axe et
+    // orbitPhase l'anomalie moyenne à t = 0. Angles en degrés.
+    void setOrbitElements(int body, float eccentricity, float inclinationDeg,
+                          float ascendingNodeDeg, float argPeriapsisDeg);
+
+    // Recalcule toutes les matrices modèle au temps t : propagation de
+    // Kepler, repères orbitaux composés par le graphe de scène (un produit
+    // par nœud dont l'orbite ou celle d'un ancêtre a bougé), puis noyau
+    // vectoriel. Kepler et le noyau sont répartis par tranches de corps sur
+    // le JobSystem.
+    void update(double t);
+    // Même résultat en scalaire par une chaîne glm::translate/rotate/scale,
+    // conservée comme référence pour les mesures.
+    void updateReference(double t);
+
+    size_t size() const { return m_size.size(); }
+    const glm::mat4 &model(size_t i) const { return m_model[i]; }
+    const std::vector<glm::mat4> &models() const { return m_model; }
+    glm::vec3 position(size_t i) const { return glm::vec3(m_posX[i], m_posY[i], m_posZ[i]); }
+    int textureLayer(size_t i) const { return m_textureLayer[i]; }
+    bool emissive(size_t i) const { return m_emissive[i] != 0; }
+    float bodySize(size_t i) const { return m_size[i]; }
+    const SceneGraph &frames() const { return m_frames; }
+
+private:
+    void propagate(double t);
+
+    std::vector<int> m_parent;
+    // Repères orbitaux des hiérarchies : local = translation sur l'orbite
+    // autour du parent, monde = position du corps. Seuls les satellites et
+    // leurs parents y ont un nœud ; un corps isolé autour de l'origine a déjà
+    // sa position monde après Kepler.
+    SceneGraph m_frames;
+    std::vector<int> m_frameOf;  // nœud de chaque corps, -1 hors hiérarchie
+    std::vector<int> m_framed;   // corps de chaque nœud, dans l'ordre du graphe
+    std::vector<float> m_size;
+    std::vector<float> m_axialTilt;   // en radians
+    std::vector<float> m_cosTilt;     // précalculés : l'inclinaison ne change pas
+    std::vector<float> m_sinTilt;
+    std::vector<float> m_spinRate;
+    std::vector<int> m_textureLayer;
+    std::vector<unsigned char> m_emissive;
+
+    // Éléments orbitaux (voir Kepler.h)
+    std::vector<float> m_semiMajorAxis;
+    std::vector<float> m_eccentricity;
+    std::vector<float> m_meanMotion;    // 1 / période, en rad par unité de temps
+    std::vector<float> m_meanAnomaly0;  // en radians
+    std::vector<float> m_px, m_py, m_pz;
+    std::vector<float> m_qx, m_qy, m_qz;
+
+    // Position monde courante et matrice modèle finale
+    std::vector<float> m_posX, m_posY, m_posZ;
+    std::vector<glm::mat4> m_model;
 };
 
 #endif // PLANET_H
@@ -0,0 +1,140 @@
+// Offline texture compressor: fills the texture cache with the BC1 mip chains
+// TextureStreamer asks for, so the viewer can stream them without decoding or
+// encoding anything at start-up.
+// With --virtual=WxH, also cuts each image into the tiled format of VirtualTexture
+// (media/cache/<name>.svt); this is where 32k sources belong, they are decoded whole.
+// Usage: textureCompressor [--size=WxH] [--virtual=WxH] [image...]   (run from the
+// build directory, like tpOpenGL; without images, compresses the planet maps)
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "BlockCompression.h"
+#include "MipChain.h"
+#include "TextureArray.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+#include "VirtualTexture.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static double psnr(const std::vector<unsigned char> &a, const unsigned char *b, int stride, int channels) {
+    double sum = 0.0;
+    const size_t texels = a.size() / channels;
+    for (size_t i = 0; i < texels; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            const double d = double(a[i * channels + c]) - double(b[i * stride + c]);
+            sum += d * d;
+        }
+    }
+    const double mse = sum / double(a.size());
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+int main(int argc, char **argv) {
+    int width = 1024, height = 512;  // taille par défaut de TextureStreamer
+    int virtualWidth = 0, virtualHeight = 0;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 7, "--size=") == 0) {
+            if (std::sscanf(arg.c_str() + 7, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                std::fprintf(stderr, "invalid size %s, expected WxH\n", arg.c_str() + 7);
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--virtual=") == 0) {
+            if (std::sscanf(arg.c_str() + 10, "%dx%d", &virtualWidth, &virtualHeight) != 2) {
+                std::fprintf(stderr, "invalid size %s, expected WxH\n", arg.c_str() + 10);
+                return 1;
+            }
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        const char *planets[] = { "sun2", "earth", "moon", "mercure", "venus", "mars", "jupiter" };
+        for (size_t i = 0; i < sizeof(planets) / sizeof(planets[0]); ++i)
+            files.push_back(std::string("../../media/") + planets[i] + ".jpg");
+    }
+
+    TextureCache cache("../../media/cache");
+    // mêmes sources et même horodatage que tpOpenGL : les images présentes
+    // dans l'archive y sont lues et datées par l'empreinte de leur contenu,
+    // sinon le viewer rejetterait chaque entrée écrite ici
+    AssetArchive archive;
+    if (archive.open("../../assets.pak"))
+        cache.setArchive(&archive);
+    size_t totalRaw = 0, totalCompressed = 0;
+    std::printf("%-28s %6s %10s %10s %7s %9s %9s\n", "image", "format", "raw KiB", "BC KiB", "ratio", "PSNR dB", "encode ms");
+    for (size_t f = 0; f < files.size(); ++f) {
+        int sourceW, sourceH, sourceChannels;
+        AssetSpan packed;
+        const bool readable = archive.find(files[f], packed)
+            ? stbi_info_from_memory(packed.data, int(packed.size), &sourceW, &sourceH, &sourceChannels) != 0
+            : stbi_info(files[f].c_str(), &sourceW, &sourceH, &sourceChannels) != 0;
+        if (!readable) {
+            std::fprintf(stderr, "cannot read %s\n", files[f].c_str());
+            continue;
+        }
+        // loadResampled rend toujours du RGB, comme pour TextureStreamer
+        const int channels = 3;
+
+        std::vector<MipLevel> levels(1);
+        levels[0].width = width;
+        levels[0].height = height;
+        levels[0].pixels = TextureArray::loadResampled(files[f], width, height, &archive);
+        std::vector<MipLevel> mips = buildMipChain(levels[0].pixels.data(), width, height, 3);
+        levels.insert(levels.end(), mips.begin(), mips.end());
+
+        const Clock::time_point start = Clock::now();
+        size_t raw = 0, compressed = 0;
+        double quality = 0.0;
+        for (size_t l = 0; l < levels.size(); ++l) {
+            MipLevel &level = levels[l];
+            raw += size_t(level.width) * level.height * channels;
+            std::vector<unsigned char> blocks = encodeBC1(level.pixels.data(), level.width, level.height, channels);
+            if (l == 0) {
+                // qualité mesurée sur le niveau plein
+                const std::vector<unsigned char> decoded = decodeBC1(blocks.data(), level.width, level.height);
+                quality = psnr(decoded, level.pixels.data(), channels, channels);
+            }
+            compressed += blocks.size();
+            level.pixels.swap(blocks);
+        }
+        const double encodeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        const std::string variant = TextureStreamer::cacheVariant(width, height, true);
+        if (!cache.store(files[f], variant, levels, channels, kCacheFormatBC1))
+            std::fprintf(stderr, "cannot write the cache entry of %s\n", files[f].c_str());
+        totalRaw += raw;
+        totalCompressed += compressed;
+        const size_t slash = files[f].find_last_of('/');
+        std::printf("%-28s %6s %10zu %10zu %6.1fx %9.2f %9.1f\n", files[f].substr(slash + 1).c_str(),
+                    "BC1", raw / 1024, compressed / 1024, double(raw) / double(compressed),
+                    quality, encodeMs);
+    }
+    if (totalCompressed > 0) {
+        std::printf("total: %zu KiB -> %zu KiB, %zu KiB of VRAM saved (mip chains at %dx%d)\n",
+                    totalRaw / 1024, totalCompressed / 1024, (totalRaw - totalCompressed) / 1024, width, height);
+    }
+    for (size_t f = 0; virtualWidth > 0 && f < files.size(); ++f) {
+        const size_t slash = files[f].find_last_of('/'), dot = files[f].find_last_of('.');
+        const std::string name = files[f].substr(slash + 1, dot == std::string::npos || dot < slash + 1 ? std::string::npos : dot - slash - 1);
+        const std::string tiles = "../../media/cache/" + name + ".svt";
+        const Clock::time_point start = Clock::now();
+        if (!buildVirtualTextureFile(files[f], tiles, virtualWidth, virtualHeight)) {
+            std::fprintf(stderr, "cannot tile %s\n", files[f].c_str());
+            continue;
+        }
+        std::printf("%s: %dx%d tiles in %.0f ms\n", tiles.c_str(), virtualWidth, virtualHeight,
+                    std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return 0;
+}
@@ -32,24 +32,34 @@
 //     gl_Position = projMat * viewMat * vec4(vPosition, 1.0);
 // }
 
+// TEX_COORD_RANGE (Mesh::kTexCoordRange) est defini par le C++ avant la
+// compilation, voir ShaderPipeline.
+
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec3 vNormal;
 layout(location = 2) in vec2 vTexCoords;
+layout(location = 3) in mat4 iModelMat; // par instance, occupe les locations 3 a 6
+layout(location = 7) in vec3 iParams;   // x : couche de texture, y : lod minimal, z : couche virtuelle
 
 
-uniform mat4 modelMat;
 uniform mat4 viewMat;
 uniform mat4 projMat;
 
 out vec3 fPosition;
 out vec3 fNormal;
 out vec2 fTexCoords;
+flat out float fLayer;
+flat out float fMinLod;
+flat out float fVirtual;
 
 void main() {
-    fPosition = vec3(modelMat * vec4(vPosition, 1.0));
-    fNormal   = mat3(modelMat) * vNormal;
+    fPosition = vec3(iModelMat * vec4(vPosition, 1.0));
+    fNormal   = mat3(iModelMat) * vNormal;
 
-    fTexCoords = vTexCoords;
+    fTexCoords = vTexCoords * TEX_COORD_RANGE; // stockees en unorm16 sur [0, TEX_COORD_RANGE]
+    fLayer = iParams.x;
+    fMinLod = iParams.y;
+    fVirtual = iParams.z;
 
     gl_Position = projMat * viewMat * vec4(fPosition, 1.0);
 }